@@ -11,10 +11,24 @@
 //-----------------------------------------------------------------------------
 //
 
+//SA_RESTART, flock() and pread()/pwrite() are not part of strict ISO C
+#define _DEFAULT_SOURCE
+
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 typedef enum _Boolean_
 {
@@ -24,10 +38,73 @@ typedef enum _Boolean_
 
 typedef struct _Breakpoint_
 {
-  char value_;
+  int value_;
   char* type_;
 } Breakpoint;
 
+typedef enum _ConditionOperation_
+{
+  CONDITION_PUSH,
+  CONDITION_LOAD,
+  CONDITION_NOT,
+  CONDITION_NEGATE,
+  CONDITION_TO_BOOLEAN,
+  CONDITION_AND_JUMP,
+  CONDITION_OR_JUMP,
+  CONDITION_ADD,
+  CONDITION_SUBTRACT,
+  CONDITION_MULTIPLY,
+  CONDITION_DIVIDE,
+  CONDITION_MODULO,
+  CONDITION_EQUAL,
+  CONDITION_NOT_EQUAL,
+  CONDITION_LESS,
+  CONDITION_LESS_EQUAL,
+  CONDITION_GREATER,
+  CONDITION_GREATER_EQUAL
+} ConditionOperation;
+
+typedef enum _ConditionVariable_
+{
+  CONDITION_VARIABLE_STATE = 0,
+  CONDITION_VARIABLE_READ = 1,
+  CONDITION_VARIABLE_WRITE = 2,
+  CONDITION_VARIABLE_POS = 3,
+  CONDITION_VARIABLE_STEPS = 4,
+  CONDITION_VARIABLE_NEXT = 5,
+  CONDITION_VARIABLE_MOVE = 6,
+  CONDITION_VARIABLE_RULE = 7,
+  CONDITION_VARIABLE_COUNT = 8
+} ConditionVariable;
+
+typedef struct _ConditionCode_
+{
+  ConditionOperation operation_;
+  long long operand_;
+} ConditionCode;
+
+typedef struct _ConditionBreakpoint_
+{
+  char* expression_;
+  ConditionCode* code_;
+  int code_length_;
+  long long hits_;
+  int ignore_count_;
+  Boolean one_shot_;
+} ConditionBreakpoint;
+
+typedef struct _ConditionParser_
+{
+  char* cursor_;
+  ConditionCode* code_;
+  int code_length_;
+  int code_limit_;
+  int depth_;
+  int max_depth_;
+  Boolean failed_;
+  Boolean out_of_memory_;
+} ConditionParser;
+
 typedef struct _Rules_
 {
   int current_state_;
@@ -35,11 +112,74 @@ typedef struct _Rules_
   char symbol_to_write_;
   int next_state_;
   char head_movement_;
+  int move_distance_;
+  int step_weight_;
 } Rules;
 
+typedef enum _WatchType_
+{
+  WATCH_READ = 0,
+  WATCH_WRITE = 1,
+  WATCH_CHANGE = 2
+} WatchType;
+
+typedef struct _Watchpoint_
+{
+  int from_;
+  int to_;
+  WatchType type_;
+} Watchpoint;
+
+#define TRACE_MAGIC "ASSBTRC1"
+#define TRACE_BUFFER_COUNT 4
+#define TRACE_BUFFER_RECORDS 65536
+#define TRACE_MAX_RECORD_BYTES 25
+
+typedef struct _Trace_
+{
+  FILE* file_;
+  pthread_t writer_;
+  pthread_mutex_t lock_;
+  pthread_cond_t filled_;
+  pthread_cond_t drained_;
+  unsigned char* buffers_[TRACE_BUFFER_COUNT];
+  int buffer_counts_[TRACE_BUFFER_COUNT];
+  int buffer_lengths_[TRACE_BUFFER_COUNT];
+  unsigned char* cursor_;
+  long long previous_step_;
+  long long previous_position_;
+  int active_buffer_;
+  int active_count_;
+  int queue_head_;
+  int queue_length_;
+  Boolean closing_;
+  Boolean write_failed_;
+} Trace;
+
+#define EXECUTION_CHECK_INTERVAL 4096
+
+typedef struct _Execution_
+{
+  pthread_t worker_;
+  Boolean running_;
+  Boolean pause_reported_;
+  atomic_int paused_;
+  atomic_int finished_;
+  atomic_llong steps_;
+  atomic_int state_;
+  atomic_int head_position_;
+  long long start_steps_;
+  struct timespec start_time_;
+  struct timespec end_time_;
+  struct sigaction previous_action_;
+} Execution;
+
 typedef struct _Turing_
 {
   char* band_;
+  char* band_memory_;
+  int band_origin_;
+  int band_capacity_;
   int head_position_;
   int start_state_;
   int current_rule_;
@@ -48,10 +188,171 @@ typedef struct _Turing_
   Rules* rules_;
   Breakpoint* breakpoints_;
   int breakpoint_counter_;
+  ConditionBreakpoint* conditions_;
+  int condition_counter_;
+  long long condition_hit_step_;
   Boolean turing_over_;
+  long long step_count_;
+  Trace* trace_;
+  Watchpoint* watchpoints_;
+  int watchpoint_counter_;
+  unsigned char* watched_pages_;
+  int watched_base_;
+  unsigned int watched_span_;
+  Execution* execution_;
+  int unfused_rules_count_;
 } Turing;
 
+typedef struct _StateSignature_
+{
+  int* signature_;
+  int length_;
+  int state_index_;
+} StateSignature;
+
+typedef struct _RuleTable_
+{
+  int symbol_index_[256];
+  int symbol_count_;
+  int* states_;
+  int state_count_;
+  int* transitions_;
+} RuleTable;
+
+#define ENUMERATION_MAX_STATES 26
+#define ENUMERATION_MAX_SYMBOLS 10
+#define ENUMERATION_MAX_TRANSITIONS 64
+#define ENUMERATION_FRONTIER_SIZE 1024
+#define ENUMERATION_OUTPUT_SIZE 65536
+#define ENUMERATION_MACHINE_TEXT (ENUMERATION_MAX_TRANSITIONS * 3 + \
+                                  ENUMERATION_MAX_STATES + 1)
+#define ENUMERATION_CHECKPOINT_MAGIC "ASSBENUM"
+
+typedef enum _EnumerationResult_
+{
+  ENUMERATION_HALTING = 0,
+  ENUMERATION_NON_HALTING = 1,
+  ENUMERATION_UNDECIDED = 2
+} EnumerationResult;
+
+typedef struct _EnumerationTransition_
+{
+  signed char write_;
+  signed char move_;
+  signed char next_;
+} EnumerationTransition;
+
+typedef struct _EnumerationMachine_
+{
+  EnumerationTransition transitions_[ENUMERATION_MAX_TRANSITIONS];
+  int defined_count_;
+  int states_used_;
+  int symbols_used_;
+} EnumerationMachine;
+
+typedef struct _EnumerationSummary_
+{
+  long long results_[3];
+  long long longest_run_;
+  char longest_machine_[ENUMERATION_MACHINE_TEXT];
+} EnumerationSummary;
+
+typedef struct _Enumeration_
+{
+  int state_count_;
+  int symbol_count_;
+  long long max_steps_;
+  EnumerationMachine* frontier_;
+  int frontier_count_;
+  int next_item_;
+  unsigned char* finished_items_;
+  FILE* checkpoint_;
+  Boolean checkpoint_failed_;
+  EnumerationSummary resumed_;
+  pthread_mutex_t lock_;
+} Enumeration;
+
+typedef struct _EnumerationWorker_
+{
+  Enumeration* enumeration_;
+  pthread_t thread_;
+  unsigned char* tape_;
+  unsigned char* snapshot_;
+  char* output_;
+  int output_length_;
+  Boolean quiet_;
+  Boolean collect_children_;
+  Boolean out_of_memory_;
+  EnumerationMachine* children_;
+  int children_count_;
+  int children_limit_;
+  EnumerationSummary subtree_;
+  EnumerationSummary total_;
+} EnumerationWorker;
+
+#define CACHE_MAGIC "ASSBCCH1"
+#define CACHE_DEFAULT_MEGABYTES 64
+#define CACHE_BYTES_PER_SLOT 1024
+
+typedef struct _CacheHeader_
+{
+  char magic_[8];
+  unsigned long long file_size_;
+  unsigned long long slot_count_;
+  unsigned long long data_offset_;
+  unsigned long long data_used_;
+  unsigned long long data_live_;
+  unsigned long long entry_count_;
+  unsigned long long clock_;
+} CacheHeader;
+
+typedef struct _CacheSlot_
+{
+  unsigned long long rules_hash_;
+  unsigned long long input_hash_;
+  unsigned long long last_used_;
+  unsigned long long band_offset_;
+  unsigned long long band_length_;
+  long long step_count_;
+  int band_first_;
+  int head_position_;
+  int final_state_;
+  int padding_;
+} CacheSlot;
+
+typedef struct _Cache_
+{
+  int file_;
+  unsigned char* memory_;
+  CacheHeader* header_;
+  CacheSlot* slots_;
+  unsigned char* data_;
+  unsigned long long data_size_;
+} Cache;
+
+typedef struct _Options_
+{
+  char* machine_file_;
+  char* trace_file_;
+  char* decode_trace_file_;
+  char* tape_file_;
+  char* dump_tape_file_;
+  Boolean optimize_;
+  Boolean run_;
+  char* script_file_;
+  int enumerate_states_;
+  int enumerate_symbols_;
+  long long max_steps_;
+  char* checkpoint_file_;
+  char* cache_file_;
+  int cache_megabytes_;
+} Options;
+
 #define RULE_PARAMETER_COUNT 5
+#define BAND_CHUNK_SIZE 65536
+#define BREAKPOINT_DISARMED INT_MIN
+#define CONDITION_STACK_SIZE 64
+#define WATCH_PAGE_SHIFT 6
 
 #define EVERYTHING_WORKED_FINE 0
 #define ERROR_CODE_WRONG_PARAMETER 1
@@ -59,45 +360,191 @@ typedef struct _Turing_
 #define ERROR_CODE_PARSING_THE_FILE_FAILED 3
 #define ERROR_CODE_READING_THE_FILE_FAILED 4
 #define ERROR_CODE_NONE_DETERMINISTIC_MACHINE 5
+#define ERROR_CODE_WRITING_THE_TRACE_FAILED 6
+#define ERROR_CODE_WRITING_THE_TAPE_FAILED 7
+#define ERROR_CODE_CHECKPOINT_FAILED 8
+#define ERROR_CODE_OPENING_THE_CACHE_FAILED 9
 
 #define OUT_OF_MEMORY "[ERR] out of memory\n"
-#define WRONG_PARAMETER_COUNT "[ERR] usage: ./assb <file>\n"
+#define WRONG_PARAMETER_COUNT "[ERR] usage: ./assb [--optimize] [--trace <out.bin>]" \
+                              " [--tape <file|->] [--dump-tape <file>]" \
+                              " [--run [--max-steps <S>]" \
+                              " [--cache <file> [--cache-size <MB>]]" \
+                              " | --script <cmds.txt>]" \
+                              " <file>\n" \
+                              "             ./assb --decode-trace <out.bin>\n" \
+                              "             ./assb --enumerate <n> <m>" \
+                              " --max-steps <S> [--checkpoint <file>]\n"
 #define PARSING_THE_FILE_FAILED "[ERR] parsing of input failed\n"
 #define READING_THE_FILE_FAILED "[ERR] reading the file failed\n"
 #define NONE_DETERMINISTIC_MACHINE "[ERR] non-deterministic turing machine\n"
+#define WRITING_THE_TRACE_FAILED "[ERR] writing the trace failed\n"
+#define WRITING_THE_TAPE_FAILED "[ERR] writing the tape failed\n"
+#define INVALID_CONDITION "[ERR] invalid breakpoint condition\n"
+#define CHECKPOINT_FAILED "[ERR] checkpoint does not match or cannot be written\n"
+#define OPENING_THE_CACHE_FAILED "[ERR] opening the cache failed\n"
 
 Boolean isPlusOrMinus(char character);
-Boolean checkIfBandIsEmpty(Turing* machine);
+Boolean findBandExtent(Turing* machine, int* first, int* last);
 Boolean checkIntBreakpoints(Turing*, char*, int);
 Boolean checkCharBreakpoints(Turing*, char*, char);
+Boolean parseInteger(char* text, int* value);
+Boolean parseLongInteger(char* text, long long* value);
+Boolean isPageWatched(Turing* machine, int position);
+Boolean isExecutionRunning(Turing* machine);
+Boolean lookupCache(Cache* cache, unsigned long long rules_hash,
+                    unsigned long long input_hash, Turing* machine,
+                    long long max_steps);
+Boolean checkWatchpoints(Turing* machine, int position, char read, char written);
+Boolean executeRule(Turing* machine, int rule_index);
+Boolean isStepObserved(Turing* machine);
+Boolean checkConditionBreakpoints(Turing* machine, int rule_index);
+Boolean acceptConditionToken(ConditionParser* parser, char* token);
+Boolean isStateComplete(RuleTable* table, int state_index);
+Boolean readVarint(FILE* file, unsigned long long* value);
+Boolean unpackVarint(unsigned char** cursor, unsigned char* end,
+                     unsigned long long* value);
+Boolean checkNonHalting(EnumerationWorker* worker, EnumerationMachine* machine,
+                        int state, long long head, long long leftmost,
+                        long long rightmost);
 
 int checkDeterministic(Turing* machine);
 int interactiveDebugMode(Turing* machine);
+int runDebuggerCommand(char* command, Turing* machine, Boolean* close_program);
+int runScript(char* filename, Turing* machine);
+int startExecution(Turing* machine, Boolean background);
+int openCache(char* filename, int megabytes, Cache* cache);
+int compareCacheSlots(const void* first, const void* second);
+int compactCacheData(Cache* cache);
 int checkMemoryAvailable(char** array, int size);
 int loadTextFile(char* filename, Turing* machine);
-int setBreakPoint(Turing* machine, char* type, char value);
+int findRule(Turing* machine);
+int findUnfusedRule(Turing* machine);
+int dumpBand(char* filename, Turing* machine);
+int loadBandLine(FILE* file, Turing* machine);
+int loadBandFile(char* filename, Turing* machine);
+int growBand(Turing* machine, long long position);
+int optimizeRules(Turing* machine);
+int fusePureMoveStates(Turing* machine);
+int mergeEquivalentStates(Turing* machine);
+int pruneUnreachableStates(Turing* machine);
+int stateIndex(RuleTable* table, int state);
+int buildRuleTable(Turing* machine, RuleTable* table);
+int compareIntegers(const void* first, const void* second);
+int compareStateSignatures(const void* first, const void* second);
+int setBreakPoint(Turing* machine, char* type, char* value);
+int setConditionBreakpoint(Turing* machine, char* expression, Boolean one_shot);
+int emitCondition(ConditionParser* parser, ConditionOperation operation,
+                  long long operand);
+int decodeTrace(char* filename);
+int packVarint(unsigned char* buffer, unsigned long long value);
+int closeTrace(Turing* machine);
+int openTrace(char* filename, Turing* machine);
 int handleUserInput(char* action, char* delimiter, Turing* machine);
+int updateWatchedPages(Turing* machine);
+int removeWatchpoint(Turing* machine, char* index);
+int setWatchpoint(Turing* machine, char* from, char* to, char* type);
+int parseArguments(int argc, char* argv[], Options* options);
+int enumerateMachines(Options* options);
+int expandEnumerationFrontier(EnumerationWorker* worker);
+int openEnumerationCheckpoint(char* filename, Enumeration* enumeration,
+                              Boolean resume);
 
 void list(Turing* machine);
+void printRule(Rules* rule);
+void freeRuleTable(RuleTable* table);
 void show(Turing* machine);
 void step(Turing* machine);
 void executeRules(Turing* machine);
+void runMachine(Turing* machine, long long max_steps);
+void showRunResult(Turing* machine);
+void closeCache(Cache* cache);
+void storeCache(Cache* cache, unsigned long long rules_hash,
+                unsigned long long input_hash, Turing* machine);
+void removeCacheSlot(Cache* cache, unsigned long long index);
+void evictCacheEntry(Cache* cache);
+void waitForExecution(Turing* machine);
+void publishExecutionProgress(Turing* machine);
+void showProgress(Turing* machine);
+void interruptExecution(int signal_number);
+void* runExecution(void* argument);
+void freeTrace(Trace* trace);
+void flushTraceBuffer(Trace* trace);
+void* writeTraceBuffers(void* argument);
 void freeMemory(Turing* machine, char*, int);
+void recordTraceStep(Trace* trace, long long step, int rule, int position);
+void packTraceRecord(Trace* trace, unsigned long long step_delta, int rule,
+                     unsigned long long position_delta);
+void compileConditionOr(ConditionParser* parser);
+void compileConditionAnd(ConditionParser* parser);
+void compileConditionSum(ConditionParser* parser);
+void compileConditionProduct(ConditionParser* parser);
+void compileConditionPrimary(ConditionParser* parser);
+void compileConditionComparison(ConditionParser* parser);
+void listConditionBreakpoints(Turing* machine);
+void listWatchpoints(Turing* machine);
+void removeConditionBreakpoint(Turing* machine, int index);
+void exploreMachine(EnumerationWorker* worker, EnumerationMachine* machine);
+void appendEnumerationChild(EnumerationWorker* worker,
+                            EnumerationMachine* machine);
+void reportEnumeratedMachine(EnumerationWorker* worker,
+                             EnumerationMachine* machine,
+                             EnumerationResult result, long long steps);
+void formatEnumeratedMachine(Enumeration* enumeration,
+                             EnumerationMachine* machine, char* text);
+void flushEnumerationOutput(EnumerationWorker* worker, int finished_item);
+void clearEnumerationSummary(EnumerationSummary* summary);
+void addEnumerationSummary(EnumerationSummary* total,
+                           EnumerationSummary* part);
+void* runEnumerationWorker(void* argument);
+
+long long zigzagDecode(unsigned long long value);
+long long evaluateCondition(ConditionBreakpoint* condition,
+                            long long* variables);
+unsigned long long zigzagEncode(long long value);
+unsigned long long mixHash(unsigned long long value);
+unsigned long long hashRules(Turing* machine);
+unsigned long long hashInput(Turing* machine);
+unsigned long long findCacheSlot(Cache* cache, unsigned long long rules_hash,
+                                 unsigned long long input_hash);
+
+EnumerationResult runEnumeratedMachine(EnumerationWorker* worker,
+                                       EnumerationMachine* machine,
+                                       long long* steps, int* halt_transition);
+
+//set by stop, quit and SIGINT, checked by a running continue
+atomic_int execution_stop_requested = 0;
 
 int main(int argc, char *argv[])
 {
   int return_value = EVERYTHING_WORKED_FINE;
+  Options options = {NULL, NULL, NULL, NULL, NULL, FALSE, FALSE, NULL, 0, 0,
+                     0, NULL, NULL, CACHE_DEFAULT_MEGABYTES};
 
-  if (argc == 2)
+  if (parseArguments(argc, argv, &options) != EVERYTHING_WORKED_FINE)
   {
-    Turing machine = {NULL, 0, 0, 0, 0, 0, NULL, NULL, 0, FALSE};
-
-    machine.band_ = malloc(50 * sizeof(char));
-    if (!machine.band_)
-      freeMemory(&machine, OUT_OF_MEMORY, ERROR_CODE_OUT_OF_MEMORY);
+    printf(WRONG_PARAMETER_COUNT);
+    return_value = ERROR_CODE_WRONG_PARAMETER;
+  }
+  else if (options.decode_trace_file_)
+  {
+    return_value = decodeTrace(options.decode_trace_file_);
+  }
+  else if (options.enumerate_states_ > 0)
+  {
+    return_value = enumerateMachines(&options);
+  }
+  else
+  {
+    Turing machine = {NULL, NULL, 0, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, NULL,
+                      0, -1, FALSE, 0, NULL, NULL, 0, NULL, 0, 0, NULL, 0};
+    Cache cache = {-1, NULL, NULL, NULL, NULL, 0};
+    Boolean cache_hit = FALSE;
+    unsigned long long rules_hash = 0;
+    unsigned long long input_hash = 0;
 
-    memset(machine.band_, '_', 49);
-    machine.band_[49] = '\0';
+    if (growBand(&machine, 0) != EVERYTHING_WORKED_FINE)
+      freeMemory(&machine, "", ERROR_CODE_OUT_OF_MEMORY);
 
     machine.rules_ = calloc(50, sizeof(Rules));
     if (!machine.rules_)
@@ -107,9 +554,43 @@ int main(int argc, char *argv[])
     if (!machine.breakpoints_)
       freeMemory(&machine, OUT_OF_MEMORY, ERROR_CODE_OUT_OF_MEMORY);
 
-    return_value = loadTextFile(argv[1], &machine);
-    if (return_value == EVERYTHING_WORKED_FINE)
+    return_value = loadTextFile(options.machine_file_, &machine);
+    if (return_value == EVERYTHING_WORKED_FINE && options.tape_file_)
+      return_value = loadBandFile(options.tape_file_, &machine);
+    if (return_value == EVERYTHING_WORKED_FINE && options.cache_file_)
+    {
+      //keyed by the rules as written, the optimizer keeps the results
+      rules_hash = hashRules(&machine);
+      input_hash = hashInput(&machine);
+      return_value = openCache(options.cache_file_, options.cache_megabytes_,
+                               &cache);
+    }
+    //optimized on a hit as well, so both print the same report
+    if (return_value == EVERYTHING_WORKED_FINE && options.optimize_)
+      return_value = optimizeRules(&machine);
+    if (return_value == EVERYTHING_WORKED_FINE && cache.memory_ &&
+        !options.trace_file_)
+      cache_hit = lookupCache(&cache, rules_hash, input_hash, &machine,
+                              options.max_steps_);
+    if (return_value == EVERYTHING_WORKED_FINE && options.trace_file_)
+      return_value = openTrace(options.trace_file_, &machine);
+    if (return_value == EVERYTHING_WORKED_FINE && cache_hit)
+      showRunResult(&machine);
+    else if (return_value == EVERYTHING_WORKED_FINE && options.run_)
+    {
+      runMachine(&machine, options.max_steps_);
+      if (cache.memory_ && machine.turing_over_)
+        storeCache(&cache, rules_hash, input_hash, &machine);
+    }
+    else if (return_value == EVERYTHING_WORKED_FINE && options.script_file_)
+      return_value = runScript(options.script_file_, &machine);
+    else if (return_value == EVERYTHING_WORKED_FINE)
       interactiveDebugMode(&machine);
+    if (return_value == EVERYTHING_WORKED_FINE && options.dump_tape_file_)
+      return_value = dumpBand(options.dump_tape_file_, &machine);
+    if (machine.trace_ && closeTrace(&machine) != EVERYTHING_WORKED_FINE)
+      return_value = ERROR_CODE_WRITING_THE_TRACE_FAILED;
+    closeCache(&cache);
 
     int free_counter = 0;
     for (; free_counter < machine.breakpoint_counter_; free_counter++)
@@ -117,20 +598,148 @@ int main(int argc, char *argv[])
       free(machine.breakpoints_[free_counter].type_);
       machine.breakpoints_[free_counter].type_ = NULL;
     }
+    while (machine.condition_counter_ > 0)
+      removeConditionBreakpoint(&machine, machine.condition_counter_ - 1);
 
-    free(machine.band_);
+    free(machine.band_memory_);
+    machine.band_memory_ = NULL;
     machine.band_ = NULL;
     free(machine.rules_);
     machine.rules_ = NULL;
     free(machine.breakpoints_);
     machine.breakpoints_ = NULL;
+    free(machine.conditions_);
+    machine.conditions_ = NULL;
+    free(machine.watchpoints_);
+    machine.watchpoints_ = NULL;
+    free(machine.watched_pages_);
+    machine.watched_pages_ = NULL;
+    free(machine.execution_);
+    machine.execution_ = NULL;
   }
-  else
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Parses the command line arguments.
+///
+/// @param argc Number of command line arguments
+/// @param argv The command line arguments
+/// @param options Struct which is filled with the given options
+/// @return int (1) - wrong parameter
+///         int (0) - arguments successfully parsed
+//
+int parseArguments(int argc, char* argv[], Options* options)
+{
+  int argument_counter = 1;
+
+  for (; argument_counter < argc; argument_counter++)
   {
-    printf(WRONG_PARAMETER_COUNT);
-    return_value = ERROR_CODE_WRONG_PARAMETER;
+    char* argument = argv[argument_counter];
+    char* value = NULL;
+
+    if (argument_counter + 1 < argc)
+      value = argv[argument_counter + 1];
+
+    if (strcmp(argument, "--trace") == 0 && value)
+    {
+      options->trace_file_ = value;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--tape") == 0 && value)
+    {
+      options->tape_file_ = value;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--dump-tape") == 0 && value)
+    {
+      options->dump_tape_file_ = value;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--optimize") == 0)
+      options->optimize_ = TRUE;
+    else if (strcmp(argument, "--run") == 0)
+      options->run_ = TRUE;
+    else if (strcmp(argument, "--script") == 0 && value)
+    {
+      options->script_file_ = value;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--decode-trace") == 0 && value)
+    {
+      options->decode_trace_file_ = value;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--enumerate") == 0 &&
+             argument_counter + 2 < argc)
+    {
+      if (!parseInteger(value, &options->enumerate_states_) ||
+          !parseInteger(argv[argument_counter + 2],
+                        &options->enumerate_symbols_))
+        return ERROR_CODE_WRONG_PARAMETER;
+      argument_counter += 2;
+    }
+    else if (strcmp(argument, "--max-steps") == 0 && value)
+    {
+      if (!parseLongInteger(value, &options->max_steps_))
+        return ERROR_CODE_WRONG_PARAMETER;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--cache") == 0 && value)
+    {
+      options->cache_file_ = value;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--cache-size") == 0 && value)
+    {
+      if (!parseInteger(value, &options->cache_megabytes_) ||
+          options->cache_megabytes_ < 1 ||
+          options->cache_megabytes_ > INT_MAX / 2048)
+        return ERROR_CODE_WRONG_PARAMETER;
+      argument_counter++;
+    }
+    else if (strcmp(argument, "--checkpoint") == 0 && value)
+    {
+      options->checkpoint_file_ = value;
+      argument_counter++;
+    }
+    else if (argument[0] != '-' && !options->machine_file_)
+      options->machine_file_ = argument;
+    else
+      return ERROR_CODE_WRONG_PARAMETER;
   }
-  return return_value;
+
+  if (options->decode_trace_file_)
+  {
+    if (options->machine_file_ || options->trace_file_ || options->optimize_ ||
+        options->tape_file_ || options->dump_tape_file_ ||
+        options->enumerate_states_ || options->max_steps_ ||
+        options->checkpoint_file_ || options->run_ || options->script_file_ ||
+        options->cache_file_)
+      return ERROR_CODE_WRONG_PARAMETER;
+  }
+  else if (options->enumerate_states_)
+  {
+    if (options->machine_file_ || options->trace_file_ || options->optimize_ ||
+        options->tape_file_ || options->dump_tape_file_ || options->run_ ||
+        options->script_file_ || options->cache_file_ ||
+        options->enumerate_states_ < 1 ||
+        options->enumerate_states_ > ENUMERATION_MAX_STATES ||
+        options->enumerate_symbols_ < 1 ||
+        options->enumerate_symbols_ > ENUMERATION_MAX_SYMBOLS ||
+        options->enumerate_states_ * options->enumerate_symbols_ >
+          ENUMERATION_MAX_TRANSITIONS ||
+        options->max_steps_ < 1 || options->max_steps_ > INT_MAX)
+      return ERROR_CODE_WRONG_PARAMETER;
+  }
+  else if (!options->machine_file_ || options->checkpoint_file_ ||
+           (options->run_ && options->script_file_) ||
+           (options->max_steps_ && !options->run_) || options->max_steps_ < 0 ||
+           (options->cache_file_ && !options->run_))
+    return ERROR_CODE_WRONG_PARAMETER;
+
+  return EVERYTHING_WORKED_FINE;
 }
 
 //-----------------------------------------------------------------------------
@@ -144,12 +753,19 @@ int main(int argc, char *argv[])
 //
 void freeMemory(Turing* machine, char* message, int exit_code)
 {
-  free(machine->band_);
+  free(machine->band_memory_);
+  machine->band_memory_ = NULL;
   machine->band_ = NULL;
   free(machine->rules_);
   machine->rules_ = NULL;
   free(machine->breakpoints_);
   machine->breakpoints_ = NULL;
+  free(machine->watchpoints_);
+  machine->watchpoints_ = NULL;
+  free(machine->watched_pages_);
+  machine->watched_pages_ = NULL;
+  free(machine->execution_);
+  machine->execution_ = NULL;
   printf("%s", message);
   exit(exit_code);
 }
@@ -220,7 +836,13 @@ int loadTextFile(char* filename, Turing* machine)
   FILE* file_to_read = fopen(filename, "r");
   if (file_to_read)
   {
-    fscanf(file_to_read, "%s\n", machine->band_);
+    if (loadBandLine(file_to_read, machine) != EVERYTHING_WORKED_FINE)
+    {
+      free(head_position);
+      free(start_state);
+      fclose(file_to_read);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
     //read aisPlusOrMinus(character)nd parse head_position
     while ((character = fgetc(file_to_read)) != '\n' && character != EOF)
     {
@@ -254,6 +876,14 @@ int loadTextFile(char* filename, Turing* machine)
     machine->head_position_ = strtol(head_position, NULL, 10);
     free(head_position);
     head_position = NULL;
+    if ((unsigned int)(machine->head_position_ + machine->band_origin_) >=
+          (unsigned int)machine->band_capacity_ &&
+        growBand(machine, machine->head_position_) != EVERYTHING_WORKED_FINE)
+    {
+      free(start_state);
+      fclose(file_to_read);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
 
     //read an parse start_state_
     character_limit = 60;
@@ -301,12 +931,27 @@ int loadTextFile(char* filename, Turing* machine)
         return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
       }
       else
-      {//TODOD reallocate if rulescounter grer rulesmax
+      {
+        if (rules_counter >= rules_limit)
+        {
+          Rules* rules = realloc(machine->rules_,
+                                 rules_limit * 2 * sizeof(Rules));
+          if (!rules)
+          {
+            fclose(file_to_read);
+            freeMemory(machine, OUT_OF_MEMORY, ERROR_CODE_OUT_OF_MEMORY);
+          }
+          machine->rules_ = rules;
+          rules_limit *= 2;
+        }
         machine->rules_[rules_counter].current_state_ = current_position;
         machine->rules_[rules_counter].readed_symbol_ = readed_symbol;
         machine->rules_[rules_counter].symbol_to_write_ = write_symbol;
         machine->rules_[rules_counter].next_state_ = next_state;
         machine->rules_[rules_counter].head_movement_ = head_movement;
+        machine->rules_[rules_counter].move_distance_ =
+          head_movement == 'R' ? 1 : (head_movement == 'L' ? -1 : 0);
+        machine->rules_[rules_counter].step_weight_ = 1;
       }
       rules_counter++;
     }
@@ -381,10 +1026,14 @@ int interactiveDebugMode(Turing* machine)
   int action_input_counter = 0;
   int return_value = EVERYTHING_WORKED_FINE;
 
-  char* action = NULL;
-  char* delimiter = " ";
   char* user_input = calloc(55, sizeof(char));
 
+  if (!user_input)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
   while (!close_program)
   {
     printf("esp> ");
@@ -398,38 +1047,29 @@ int interactiveDebugMode(Turing* machine)
         return_value = checkMemoryAvailable(&user_input,
                                            (action_input_limit + 1));
         if (return_value == ERROR_CODE_OUT_OF_MEMORY)
+        {
+          atomic_store(&execution_stop_requested, TRUE);
+          waitForExecution(machine);
           return return_value;
+        }
       }
     }
 
-    //check if there is a user input
-    if (user_input[0] != 0  && user_input)
-    {
-      user_input[action_input_counter] = '\0';
-      action = strtok(user_input, delimiter);
-      if (strcmp(action, "quit") == 0 || character == EOF || feof(stdin))
-      {
-        printf("Bye.\n");
-        close_program = TRUE;
-      }
-      else
-      {
-        return_value = handleUserInput(action, delimiter, machine);
-      }
-    }
-
-    //Resets the user input string to the size of 50
+    //the input buffer keeps its size for the next command
+    user_input[action_input_counter] = '\0';
     action_input_counter = 0;
-    return_value = checkMemoryAvailable(&user_input, 50);
-    if (return_value == ERROR_CODE_OUT_OF_MEMORY)
-      return return_value;
-    user_input[49] = '\0';
 
-    if (machine->turing_over_)
+    //stdin may already be used up, e.g. by --tape -
+    if (character == EOF || feof(stdin))
     {
+      atomic_store(&execution_stop_requested, TRUE);
+      waitForExecution(machine);
+      printf("Bye.\n");
       close_program = TRUE;
-      printf("machine stopped in state %i\n", machine->current_state_);
-      show(machine);
+    }
+    else
+    {
+      return_value = runDebuggerCommand(user_input, machine, &close_program);
     }
   }
   free(user_input);
@@ -440,421 +1080,4253 @@ int interactiveDebugMode(Turing* machine)
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to reacting to user inputs.
+/// Executes one line of debugger commands, shared by the interactive mode
+/// and the script mode.
 ///
-/// @param action //TODO
-/// @param delimiter //TODO
+/// @param command The line, it is split up by strtok()
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
+/// @param close_program Set to TRUE after quit or when the machine stopped
 /// @return int (0) - no errors
 ///         int (2) - out of memory
 //
-int handleUserInput(char* action, char* delimiter, Turing* machine)
+int runDebuggerCommand(char* command, Turing* machine, Boolean* close_program)
 {
   int return_value = EVERYTHING_WORKED_FINE;
+  char* delimiter = " ";
+  char* action = strtok(command, delimiter);
 
-  if (strcmp(action, "list") == 0)
+  if (action && strcmp(action, "quit") == 0)
   {
-    list(machine);
+    atomic_store(&execution_stop_requested, TRUE);
+    waitForExecution(machine);
+    printf("Bye.\n");
+    *close_program = TRUE;
   }
-  else if (strcmp(action, "step") == 0)
+  else if (action)
   {
-    step(machine);
+    return_value = handleUserInput(action, delimiter, machine);
   }
-  else if (strcmp(action, "show") == 0)
+
+  if (!isExecutionRunning(machine) && machine->turing_over_)
   {
+    *close_program = TRUE;
+    printf("machine stopped in state %i\n", machine->current_state_);
     show(machine);
   }
-  else if (strcmp(action, "continue") == 0)
-  {
-    executeRules(machine);
-  }
-  else if (strcmp(action, "break") == 0)
-  {
-    char* breakpoint_type = NULL;
-    char* second_parameter = NULL;
-    breakpoint_type = strtok(NULL, delimiter);
-    second_parameter = strtok(NULL, delimiter);
-
-    if (breakpoint_type && second_parameter)
-    {
-      char breakpoint_value = second_parameter[0];
-      return_value = setBreakPoint(machine, breakpoint_type, breakpoint_value);
-    }
-  }
 
   return return_value;
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to display all rules of the Turingmachine.
+/// Executes the debugger commands of a script file like the interactive
+/// mode, but without prompts. The whole script is read at once and split
+/// into lines in place.
 ///
+/// @param filename Path of the script file
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+///         int (4) - reading the file failed
 //
-void list(Turing* machine)
+int runScript(char* filename, Turing* machine)
 {
-  int jump = -1;
-  int state = 0;
-  int next_state = 0;
-  int rules_counter = 0;
-  int rules_count = machine->rules_count_;
-  int head_position = machine->head_position_;
+  int script_length = 0;
+  int script_limit = BAND_CHUNK_SIZE;
+  ssize_t chunk_length = 0;
+  struct stat file_status;
+  Boolean close_program = FALSE;
+  int return_value = EVERYTHING_WORKED_FINE;
+  char* script = NULL;
+  char* command = NULL;
+  char* line_end = NULL;
 
-  char symbol = 0;
-  char head_movement = 0;
-  char symbol_to_write = 0;
-  Boolean FOUND_RULE = FALSE;
-  
-  for (; rules_counter < rules_count; rules_counter++)
+  int file = open(filename, O_RDONLY);
+  if (file < 0)
   {
-    symbol = machine->rules_[rules_counter].readed_symbol_;
-    state = machine->rules_[rules_counter].current_state_;
-    next_state = machine->rules_[rules_counter].next_state_;
-    head_movement = machine->rules_[rules_counter].head_movement_;
-    symbol_to_write = machine->rules_[rules_counter].symbol_to_write_;
-    
-    if (symbol == machine->band_[head_position] &&
-        state == machine->current_state_ && !FOUND_RULE)
-    {
-      printf(">>> ");
-      FOUND_RULE = TRUE;
-      jump = rules_counter;
-      rules_counter = -1;
-    }
-    
-    if (FOUND_RULE && rules_counter != jump)
-      printf("%i %c -> %c %i %c \n",
-             state, symbol, symbol_to_write, next_state, head_movement);
-    
-    //if no rule matches then start from the beginning without showing next rule
-    if (rules_counter == (rules_count - 1) && !FOUND_RULE)
+    printf(READING_THE_FILE_FAILED);
+    return ERROR_CODE_READING_THE_FILE_FAILED;
+  }
+  if (fstat(file, &file_status) == 0 && S_ISREG(file_status.st_mode) &&
+      file_status.st_size >= script_limit && file_status.st_size < INT_MAX)
+    script_limit = file_status.st_size + 1;
+
+  do
+  {
+    if (!script || script_length + 1 >= script_limit)
     {
-      rules_counter = -1;
-      FOUND_RULE = TRUE;
+      if (script)
+        script_limit *= 2;
+      if (checkMemoryAvailable(&script, script_limit) != EVERYTHING_WORKED_FINE)
+      {
+        close(file);
+        return ERROR_CODE_OUT_OF_MEMORY;
+      }
     }
+
+    chunk_length = read(file, script + script_length,
+                        script_limit - script_length - 1);
+    if (chunk_length > 0)
+      script_length += chunk_length;
+  } while (chunk_length > 0 || (chunk_length < 0 && errno == EINTR));
+  close(file);
+
+  if (chunk_length < 0)
+  {
+    free(script);
+    printf(READING_THE_FILE_FAILED);
+    return ERROR_CODE_READING_THE_FILE_FAILED;
+  }
+  script[script_length] = '\0';
+
+  command = script;
+  while (!close_program && command < script + script_length &&
+         return_value == EVERYTHING_WORKED_FINE)
+  {
+    line_end = strchr(command, '\n');
+    if (line_end)
+      *line_end = '\0';
+    else
+      line_end = script + script_length;
+    if (line_end > command && line_end[-1] == '\r')
+      line_end[-1] = '\0';
+
+    return_value = runDebuggerCommand(command, machine, &close_program);
+    command = line_end + 1;
   }
+  if (!close_program)
+  {
+    atomic_store(&execution_stop_requested, TRUE);
+    waitForExecution(machine);
+    printf("Bye.\n");
+  }
+
+  free(script);
+  return return_value;
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to display the band of the Turingmachine.
+/// Runs the machine without debugger until it stops or the step limit is
+/// reached and prints the final state and band.
 ///
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
+/// @param max_steps Step limit, 0 for none
 //
-void show(Turing* machine)
+void runMachine(Turing* machine, long long max_steps)
 {
-  if (!checkIfBandIsEmpty(machine))
-  {
-    char symbol = 0;
-    int band_position = 0;
-    int band_length = strlen(machine->band_);
+  int rule_index = 0;
+  //without fused rules both lookups agree and findRule is the cheaper one
+  Boolean unfused = machine->unfused_rules_count_ > 0 &&
+                    isStepObserved(machine);
 
-    if (machine->head_position_ < 0)
-      band_position = machine->head_position_;
-    else if (machine->head_position_ > band_length)
-      band_length = machine->head_position_ + 1;
-
-    for (; band_position < band_length; band_position++)
+  while (max_steps == 0 || machine->step_count_ < max_steps)
+  {
+    rule_index = unfused ? findUnfusedRule(machine) : findRule(machine);
+    if (rule_index < 0)
     {
-      if (band_position < 0 || band_position > (strlen(machine->band_) - 1))
-      {
-        symbol = '_';
-      }
-      else
-      {
-        symbol = machine->band_[band_position];
-      }
-      if (band_position == machine->head_position_)
-      {
-        printf(">%c<", symbol);
-      }
-      else
-      {
-        printf("%c", symbol);
-      }
-      if (band_position < band_length - 1)
-      {
-        printf("|");
-      }
+      machine->turing_over_ = TRUE;
+      break;
     }
+    //a fused rule must not jump over the limit, its steps are run unfused
+    if (max_steps != 0 &&
+        machine->step_count_ + machine->rules_[rule_index].step_weight_ >
+          max_steps)
+      rule_index = findUnfusedRule(machine);
+    executeRule(machine, rule_index);
   }
-  else
-    printf(">_<");
 
-  printf("\n");
+  showRunResult(machine);
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to check if the band of the turing machine is empty.
+/// Function to display the final state, the step count and the band after
+/// the machine was run without debugger.
 ///
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
-/// @return Boolean (TRUE) - band is empty
-///         Boolean (FALSE) - band is not empty
 //
-Boolean checkIfBandIsEmpty(Turing* machine)
+void showRunResult(Turing* machine)
 {
-  int band_position = 0;
-  Boolean is_empty = FALSE;
-  int band_length = strlen(machine->band_);
-
-  for (; band_position < band_length; band_position++)
-    if (machine->band_[band_position] == '_')
-      is_empty = TRUE;
-
-  return is_empty;
+  if (machine->turing_over_)
+    printf("machine stopped in state %i after %lld steps\n",
+           machine->current_state_, machine->step_count_);
+  else
+    printf("step limit reached in state %i after %lld steps\n",
+           machine->current_state_, machine->step_count_);
+  show(machine);
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to execute the next matching rule and display the executed rule.
+/// Starts continue on a worker thread. In the foreground the debugger
+/// waits for it (Ctrl-C pauses it), in the background it returns at once.
 ///
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
+/// @param background Whether the debugger returns to the prompt at once
+/// @return int (0) - no errors
+///         int (2) - out of memory
 //
-void step(Turing* machine)
+int startExecution(Turing* machine, Boolean background)
 {
-  int next_state = 0;
-  int rules_counter = 0;
-  int current_state = 0;
-  int state_at_header_position = machine->current_state_;
-  int head_position = machine->head_position_;
-
-  char symbol = 0;
-  char head_movement = 0;
-  char symbol_to_read = 0;
-  char symbol_to_write = 0;
+  Execution* execution = machine->execution_;
+  struct sigaction interrupt_action;
 
+  if (!execution)
+  {
+    execution = calloc(1, sizeof(Execution));
+    if (!execution)
+    {
+      printf(OUT_OF_MEMORY);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
+    machine->execution_ = execution;
+  }
+
+  atomic_store(&execution_stop_requested, FALSE);
+  atomic_store(&execution->finished_, FALSE);
+  atomic_store(&execution->paused_, FALSE);
+  execution->pause_reported_ = FALSE;
+  execution->start_steps_ = machine->step_count_;
+  publishExecutionProgress(machine);
+  clock_gettime(CLOCK_MONOTONIC, &execution->start_time_);
+
+  //Ctrl-C pauses the running continue instead of ending the program, at an
+  //idle prompt it keeps its usual meaning
+  memset(&interrupt_action, 0, sizeof(interrupt_action));
+  interrupt_action.sa_handler = interruptExecution;
+  interrupt_action.sa_flags = SA_RESTART;
+  sigemptyset(&interrupt_action.sa_mask);
+  sigaction(SIGINT, &interrupt_action, &execution->previous_action_);
+
+  if (pthread_create(&execution->worker_, NULL, runExecution, machine) != 0)
+  {
+    //without a thread continue still works, just not in the background
+    runExecution(machine);
+    sigaction(SIGINT, &execution->previous_action_, NULL);
+    if (atomic_load(&execution->paused_))
+      showProgress(machine);
+    return EVERYTHING_WORKED_FINE;
+  }
+  execution->running_ = TRUE;
+
+  if (!background)
+    waitForExecution(machine);
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Worker thread of continue.
+///
+/// @param argument Struct with all components to descripe the turing machine
+/// @return void* Always NULL
+//
+void* runExecution(void* argument)
+{
+  Turing* machine = argument;
+  Execution* execution = machine->execution_;
+
+  executeRules(machine);
+  publishExecutionProgress(machine);
+  clock_gettime(CLOCK_MONOTONIC, &execution->end_time_);
+  atomic_store(&execution->finished_, TRUE);
+
+  return NULL;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Waits until a running continue has finished or was paused. A paused
+/// continue reports its progress.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void waitForExecution(Turing* machine)
+{
+  if (!isExecutionRunning(machine))
+    return;
+
+  pthread_join(machine->execution_->worker_, NULL);
+  machine->execution_->running_ = FALSE;
+  sigaction(SIGINT, &machine->execution_->previous_action_, NULL);
+
+  //a progress command may already have shown the pause
+  if (atomic_load(&machine->execution_->paused_) &&
+      !machine->execution_->pause_reported_)
+    showProgress(machine);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check whether continue is running on its worker thread.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return Boolean (TRUE) - continue is running
+///         Boolean (FALSE) - the machine can be used
+//
+Boolean isExecutionRunning(Turing* machine)
+{
+  return machine->execution_ && machine->execution_->running_;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Publishes the step count, state and head position of the running
+/// continue for the progress command.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void publishExecutionProgress(Turing* machine)
+{
+  Execution* execution = machine->execution_;
+
+  atomic_store_explicit(&execution->steps_, machine->step_count_,
+                        memory_order_relaxed);
+  atomic_store_explicit(&execution->state_, machine->current_state_,
+                        memory_order_relaxed);
+  atomic_store_explicit(&execution->head_position_, machine->head_position_,
+                        memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to display the progress: steps, steps per second of the last
+/// or the running continue, state and head position. While continue is
+/// running, the values it published last are shown.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void showProgress(Turing* machine)
+{
+  Execution* execution = machine->execution_;
+  char* status = "running";
+  long long steps = 0;
+  int state = 0;
+  int head_position = 0;
+  double seconds = 0;
+  double steps_per_second = 0;
+  struct timespec end_time;
+
+  if (isExecutionRunning(machine))
+  {
+    steps = atomic_load(&execution->steps_);
+    state = atomic_load(&execution->state_);
+    head_position = atomic_load(&execution->head_position_);
+    if (atomic_load(&execution->finished_))
+      status = atomic_load(&execution->paused_) ? "paused" : "finished";
+  }
+  else
+  {
+    steps = machine->step_count_;
+    state = machine->current_state_;
+    head_position = machine->head_position_;
+    if (machine->turing_over_)
+      status = "halted";
+    else if (execution && atomic_load(&execution->paused_))
+      status = "paused";
+    else
+      status = "stopped";
+  }
+
+  if (execution)
+  {
+    if (atomic_load(&execution->finished_))
+      end_time = execution->end_time_;
+    else
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+    seconds = (end_time.tv_sec - execution->start_time_.tv_sec) +
+              (end_time.tv_nsec - execution->start_time_.tv_nsec) / 1e9;
+    if (seconds > 0)
+      steps_per_second = (atomic_load(&execution->steps_) -
+                          execution->start_steps_) / seconds;
+  }
+
+  if (execution && !strcmp(status, "paused"))
+    execution->pause_reported_ = TRUE;
+
+  printf("%s: %lld steps, %.0f steps/sec, state %i, head position %i\n",
+         status, steps, steps_per_second, state, head_position);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// SIGINT handler of the debugger, pauses a running continue.
+///
+/// @param signal_number Number of the signal
+//
+void interruptExecution(int signal_number)
+{
+  (void)signal_number;
+  atomic_store(&execution_stop_requested, TRUE);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to reacting to user inputs.
+///
+/// @param action //TODO
+/// @param delimiter //TODO
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int handleUserInput(char* action, char* delimiter, Turing* machine)
+{
+  int return_value = EVERYTHING_WORKED_FINE;
+
+  //all other commands need the machine, so they wait for continue &
+  if (strcmp(action, "progress") != 0 && strcmp(action, "stop") != 0)
+    waitForExecution(machine);
+
+  if (strcmp(action, "list") == 0)
+  {
+    list(machine);
+  }
+  else if (strcmp(action, "step") == 0)
+  {
+    step(machine);
+  }
+  else if (strcmp(action, "show") == 0)
+  {
+    show(machine);
+  }
+  else if (strcmp(action, "continue") == 0)
+  {
+    char* mode = strtok(NULL, delimiter);
+    return_value = startExecution(machine, mode && strcmp(mode, "&") == 0);
+  }
+  else if (strcmp(action, "progress") == 0)
+  {
+    showProgress(machine);
+  }
+  else if (strcmp(action, "stop") == 0)
+  {
+    atomic_store(&execution_stop_requested, TRUE);
+    waitForExecution(machine);
+  }
+  else if (strcmp(action, "break") == 0 || strcmp(action, "tbreak") == 0)
+  {
+    char* breakpoint_type = NULL;
+    char* second_parameter = NULL;
+    Boolean one_shot = strcmp(action, "tbreak") == 0;
+    breakpoint_type = strtok(NULL, delimiter);
+
+    if (breakpoint_type && strcmp(breakpoint_type, "if") == 0)
+    {
+      char* expression = strtok(NULL, "");
+      if (expression)
+        return_value = setConditionBreakpoint(machine, expression, one_shot);
+    }
+    else if (!one_shot)
+    {
+      second_parameter = strtok(NULL, delimiter);
+      if (breakpoint_type && second_parameter)
+        return_value = setBreakPoint(machine, breakpoint_type,
+                                     second_parameter);
+    }
+  }
+  else if (strcmp(action, "breaks") == 0)
+  {
+    listConditionBreakpoints(machine);
+  }
+  else if (strcmp(action, "delete") == 0)
+  {
+    int breakpoint_index = 0;
+    if (parseInteger(strtok(NULL, delimiter), &breakpoint_index) &&
+        breakpoint_index >= 1 && breakpoint_index <= machine->condition_counter_)
+      removeConditionBreakpoint(machine, breakpoint_index - 1);
+  }
+  else if (strcmp(action, "ignore") == 0)
+  {
+    int breakpoint_index = 0;
+    int ignore_count = 0;
+    if (parseInteger(strtok(NULL, delimiter), &breakpoint_index) &&
+        parseInteger(strtok(NULL, delimiter), &ignore_count) &&
+        breakpoint_index >= 1 &&
+        breakpoint_index <= machine->condition_counter_ && ignore_count >= 0)
+      machine->conditions_[breakpoint_index - 1].ignore_count_ = ignore_count;
+  }
+  else if (strcmp(action, "watch") == 0)
+  {
+    char* from = strtok(NULL, delimiter);
+    char* to = strtok(NULL, delimiter);
+    char* watch_type = strtok(NULL, delimiter);
+
+    if (from && to)
+      return_value = setWatchpoint(machine, from, to, watch_type);
+  }
+  else if (strcmp(action, "watches") == 0)
+  {
+    listWatchpoints(machine);
+  }
+  else if (strcmp(action, "unwatch") == 0)
+  {
+    char* watchpoint_index = strtok(NULL, delimiter);
+
+    if (watchpoint_index)
+      return_value = removeWatchpoint(machine, watchpoint_index);
+  }
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to display all rules of the Turingmachine.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void list(Turing* machine)
+{
+  int jump = -1;
+  int state = 0;
+  int rules_counter = 0;
+  int rules_count = machine->rules_count_;
+  int head_position = machine->head_position_;
+
+  char symbol = 0;
+  Rules* rule = NULL;
   Boolean FOUND_RULE = FALSE;
+  
+  for (; rules_counter < rules_count; rules_counter++)
+  {
+    rule = &machine->rules_[rules_counter];
+    symbol = rule->readed_symbol_;
+    state = rule->current_state_;
+    
+    if (symbol == machine->band_[head_position] &&
+        state == machine->current_state_ && !FOUND_RULE)
+    {
+      printf(">>> ");
+      FOUND_RULE = TRUE;
+      jump = rules_counter;
+      rules_counter = -1;
+    }
+    
+    if (FOUND_RULE && rules_counter != jump)
+      printRule(rule);
+    
+    //if no rule matches then start from the beginning without showing next rule
+    if (rules_counter == (rules_count - 1) && !FOUND_RULE)
+    {
+      rules_counter = -1;
+      FOUND_RULE = TRUE;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to display one rule. Rules fused by the optimizer move more than
+/// one cell, so their distance is appended to the head movement.
+///
+/// @param rule The rule to be displayed.
+//
+void printRule(Rules* rule)
+{
+  printf("%i %c -> %c %i %c", rule->current_state_, rule->readed_symbol_,
+         rule->symbol_to_write_, rule->next_state_, rule->head_movement_);
+  if (rule->move_distance_ > 1 || rule->move_distance_ < -1)
+    printf("%i", abs(rule->move_distance_));
+  printf(" \n");
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to display the band of the Turingmachine.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void show(Turing* machine)
+{
+  int band_position = 0;
+  int last_position = 0;
+
+  if (findBandExtent(machine, &band_position, &last_position))
+  {
+    char symbol = 0;
+    int band_length = 0;
+
+    if (band_position > 0)
+      band_position = 0;
+    if (machine->head_position_ < band_position)
+      band_position = machine->head_position_;
+    else if (machine->head_position_ > last_position)
+      last_position = machine->head_position_;
+    band_length = last_position + 1;
+
+    for (; band_position < band_length; band_position++)
+    {
+      symbol = machine->band_[band_position];
+      if (band_position == machine->head_position_)
+      {
+        printf(">%c<", symbol);
+      }
+      else
+      {
+        printf("%c", symbol);
+      }
+      if (band_position < band_length - 1)
+      {
+        printf("|");
+      }
+    }
+  }
+  else
+    printf(">_<");
+
+  printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Grows the memory of the band so that the given position can be stored.
+/// The band grows at least by its current size on the side of the position,
+/// new cells are blank. Positions stay the same, only band_ is moved.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param position The position which must be stored afterwards.
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int growBand(Turing* machine, long long position)
+{
+  long long left_cells = machine->band_origin_;
+  long long right_cells = machine->band_capacity_ - machine->band_origin_;
+  char* band_memory = NULL;
+
+  while (position < -left_cells)
+    left_cells = left_cells * 2 + BAND_CHUNK_SIZE;
+  while (position >= right_cells)
+    right_cells = right_cells * 2 + BAND_CHUNK_SIZE;
+
+  if (left_cells + right_cells > INT_MAX)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  band_memory = malloc(left_cells + right_cells);
+  if (!band_memory)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  memset(band_memory, '_', left_cells + right_cells);
+  if (machine->band_memory_)
+    memcpy(band_memory + left_cells - machine->band_origin_,
+           machine->band_memory_, machine->band_capacity_);
+  free(machine->band_memory_);
+
+  machine->band_memory_ = band_memory;
+  machine->band_origin_ = left_cells;
+  machine->band_capacity_ = left_cells + right_cells;
+  machine->band_ = band_memory + left_cells;
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to find the leftmost and the rightmost symbol of the band which
+/// is not blank.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param first Position of the leftmost symbol.
+/// @param last Position of the rightmost symbol.
+/// @return Boolean (TRUE) - band contains a symbol
+///         Boolean (FALSE) - band is empty
+//
+Boolean findBandExtent(Turing* machine, int* first, int* last)
+{
+  int band_position = 0;
+  int band_length = machine->band_capacity_;
+
+  while (band_position < band_length &&
+         machine->band_memory_[band_position] == '_')
+    band_position++;
+  if (band_position == band_length)
+    return FALSE;
+
+  while (machine->band_memory_[band_length - 1] == '_')
+    band_length--;
+
+  *first = band_position - machine->band_origin_;
+  *last = band_length - 1 - machine->band_origin_;
+  return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Reads the first line of the machine file as band, chunk by chunk right
+/// into the memory of the band.
+///
+/// @param file The opened machine file.
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int loadBandLine(FILE* file, Turing* machine)
+{
+  int band_length = 0;
+  int chunk_length = 0;
+
+  do
+  {
+    if (band_length + BAND_CHUNK_SIZE >=
+        machine->band_capacity_ - machine->band_origin_ &&
+        growBand(machine, (long long)band_length + BAND_CHUNK_SIZE) !=
+          EVERYTHING_WORKED_FINE)
+      return ERROR_CODE_OUT_OF_MEMORY;
+
+    if (!fgets(machine->band_ + band_length, BAND_CHUNK_SIZE + 1, file))
+      break;
+    chunk_length = strlen(machine->band_ + band_length);
+    band_length += chunk_length;
+  } while (chunk_length > 0 && machine->band_[band_length - 1] != '\n');
+
+  machine->band_[band_length] = '_';
+  while (band_length > 0 && isspace((unsigned char)
+                                    machine->band_[band_length - 1]))
+    machine->band_[--band_length] = '_';
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Replaces the band by the content of a separate tape file (or stdin for
+/// "-"). The file is read in large chunks directly into the memory of the
+/// band; for regular files the band is sized up front. A trailing newline
+/// is not part of the band.
+///
+/// @param filename Path of the tape file, "-" for stdin.
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+///         int (4) - reading the file failed
+//
+int loadBandFile(char* filename, Turing* machine)
+{
+  long long band_length = 0;
+  ssize_t chunk_length = 0;
+  struct stat file_status;
+
+  int file = strcmp(filename, "-") == 0 ? STDIN_FILENO : open(filename, O_RDONLY);
+  if (file < 0)
+  {
+    printf(READING_THE_FILE_FAILED);
+    return ERROR_CODE_READING_THE_FILE_FAILED;
+  }
+
+  memset(machine->band_memory_, '_', machine->band_capacity_);
+  if (fstat(file, &file_status) == 0 && S_ISREG(file_status.st_mode) &&
+      file_status.st_size >= machine->band_capacity_ - machine->band_origin_ &&
+      growBand(machine, file_status.st_size) != EVERYTHING_WORKED_FINE)
+  {
+    if (file != STDIN_FILENO)
+      close(file);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  do
+  {
+    if (band_length + 1 >= machine->band_capacity_ - machine->band_origin_ &&
+        growBand(machine, band_length + BAND_CHUNK_SIZE) !=
+          EVERYTHING_WORKED_FINE)
+    {
+      if (file != STDIN_FILENO)
+        close(file);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
+
+    chunk_length = read(file, machine->band_ + band_length,
+                        machine->band_capacity_ - machine->band_origin_ -
+                        band_length - 1);
+    if (chunk_length > 0)
+      band_length += chunk_length;
+  } while (chunk_length > 0 || (chunk_length < 0 && errno == EINTR));
+
+  if (file != STDIN_FILENO)
+    close(file);
+  if (chunk_length < 0)
+  {
+    printf(READING_THE_FILE_FAILED);
+    return ERROR_CODE_READING_THE_FILE_FAILED;
+  }
+
+  while (band_length > 0 && isspace((unsigned char)
+                                    machine->band_[band_length - 1]))
+    machine->band_[--band_length] = '_';
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Writes the band from position 0 (or the leftmost symbol, if it is left
+/// of 0) to the rightmost symbol into a file (or stdout for "-"). The cells
+/// are written straight from the memory of the band.
+///
+/// @param filename Path of the file, "-" for stdout.
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (7) - writing the tape failed
+//
+int dumpBand(char* filename, Turing* machine)
+{
+  int first = 0;
+  int last = 0;
+  long long written = 0;
+  long long band_length = 1;
+  ssize_t chunk_length = 0;
+  char* band_start = machine->band_;
+
+  int file = STDOUT_FILENO;
+  if (strcmp(filename, "-") == 0)
+    fflush(stdout);
+  else
+    file = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file < 0)
+  {
+    printf(WRITING_THE_TAPE_FAILED);
+    return ERROR_CODE_WRITING_THE_TAPE_FAILED;
+  }
+
+  if (findBandExtent(machine, &first, &last))
+  {
+    if (first > 0)
+      first = 0;
+    band_start = machine->band_ + first;
+    band_length = (long long)last - first + 1;
+  }
+
+  while (written < band_length &&
+         ((chunk_length = write(file, band_start + written,
+                                band_length - written)) > 0 ||
+          (chunk_length < 0 && errno == EINTR)))
+    if (chunk_length > 0)
+      written += chunk_length;
+
+  if (written < band_length || write(file, "\n", 1) != 1)
+    written = -1;
+  if (file != STDOUT_FILENO && close(file) != 0)
+    written = -1;
+  if (written < 0)
+  {
+    printf(WRITING_THE_TAPE_FAILED);
+    return ERROR_CODE_WRITING_THE_TAPE_FAILED;
+  }
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to find the rule matching the current state and the symbol
+/// at the head position. The search goes on into the unfused copy of the
+/// rules, since a machine stopped inside a fused rule is in a state which
+/// only has rules there.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int Index of the matching rule, -1 if no rule matches
+//
+int findRule(Turing* machine)
+{
+  int rules_counter = 0;
+  int rules_end = machine->rules_count_ + machine->unfused_rules_count_;
+  int current_state = machine->current_state_;
+  char symbol = machine->band_[machine->head_position_];
+
+  for (; rules_counter < rules_end; rules_counter++)
+    if (machine->rules_[rules_counter].current_state_ == current_state &&
+        machine->rules_[rules_counter].readed_symbol_ == symbol)
+      return rules_counter;
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to find the rule matching the current state and the symbol at
+/// the head position in the unfused copy of the rules, which is stored
+/// behind the rules by fusePureMoveStates(). Without a copy the rules
+/// themselves are searched.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int Index of the matching rule, -1 if no rule matches
+//
+int findUnfusedRule(Turing* machine)
+{
+  int rules_counter = machine->unfused_rules_count_ > 0 ?
+                      machine->rules_count_ : 0;
+  int rules_end = machine->rules_count_ + machine->unfused_rules_count_;
+  int current_state = machine->current_state_;
+  char symbol = machine->band_[machine->head_position_];
+
+  for (; rules_counter < rules_end; rules_counter++)
+    if (machine->rules_[rules_counter].current_state_ == current_state &&
+        machine->rules_[rules_counter].readed_symbol_ == symbol)
+      return rules_counter;
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to execute one rule at the head position.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param rule_index Index of the rule to be executed.
+/// @return Boolean (TRUE) - a watchpoint was hit
+///         Boolean (FALSE) - no watchpoint was hit
+//
+Boolean executeRule(Turing* machine, int rule_index)
+{
+  Rules* rule = &machine->rules_[rule_index];
+  int head_position = machine->head_position_;
+  char symbol = machine->band_[head_position];
+
+  machine->current_rule_ = rule_index;
+  machine->current_state_ = rule->next_state_;
+  machine->band_[head_position] = rule->symbol_to_write_;
+  machine->head_position_ += rule->move_distance_;
+  if ((unsigned int)(machine->head_position_ + machine->band_origin_) >=
+        (unsigned int)machine->band_capacity_ &&
+      growBand(machine, machine->head_position_) != EVERYTHING_WORKED_FINE)
+    freeMemory(machine, "", ERROR_CODE_OUT_OF_MEMORY);
+
+  machine->step_count_ += rule->step_weight_;
+  if (machine->trace_)
+    recordTraceStep(machine->trace_, machine->step_count_,
+                    rule_index, head_position);
+
+  return isPageWatched(machine, head_position) &&
+         checkWatchpoints(machine, head_position, symbol,
+                          rule->symbol_to_write_);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Checks whether single steps are observed by breakpoints, watchpoints,
+/// conditional breakpoints or the trace. A fused rule would skip the states
+/// and cells of the steps it replaces, so it has to be executed unfused
+/// then.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return Boolean (TRUE) - steps are observed
+///         Boolean (FALSE) - fused rules can be executed at once
+//
+Boolean isStepObserved(Turing* machine)
+{
+  return machine->breakpoint_counter_ > 0 || machine->watchpoint_counter_ > 0 ||
+         machine->condition_counter_ > 0 || machine->trace_;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to execute the next matching rule and display the executed rule.
+/// A step is always a single one, even if the optimizer fused the rule.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void step(Turing* machine)
+{
+  int rule_index = findUnfusedRule(machine);
+
+  if (rule_index >= 0)
+  {
+    Rules* rule = &machine->rules_[rule_index];
+    executeRule(machine, rule_index);
+    printRule(rule);
+  }
+  else
+    machine->turing_over_ = TRUE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to execute as many rules as possible till the next break point or
+/// the end of the program (which means no rule is matching anymore).
+/// All breakpoints are checked once per step, before the step is executed.
+/// Every EXECUTION_CHECK_INTERVAL steps the progress is published and the
+/// stop flag is checked, so stop and Ctrl-C pause the loop.
+/// While steps are observed, fused rules are executed unfused.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void executeRules(Turing* machine)
+{
+  int rule_index = 0;
+  int head_position = 0;
+  Boolean unfused = machine->unfused_rules_count_ > 0 &&
+                    isStepObserved(machine);
+  Rules* rule = NULL;
+
+  while (TRUE)
+  {
+    head_position = machine->head_position_;
+    if (machine->breakpoint_counter_ > 0 &&
+        (checkIntBreakpoints(machine, "pos", head_position) ||
+         checkIntBreakpoints(machine, "state", machine->current_state_) ||
+         checkCharBreakpoints(machine, "read", machine->band_[head_position])))
+      break;
+
+    rule_index = unfused ? findUnfusedRule(machine) : findRule(machine);
+    if (rule_index < 0)
+    {
+      machine->turing_over_ = TRUE;
+      break;
+    }
+    rule = &machine->rules_[rule_index];
+
+    if (machine->breakpoint_counter_ > 0 &&
+        checkCharBreakpoints(machine, "write", rule->symbol_to_write_))
+      break;
+
+    if (machine->condition_counter_ > 0 &&
+        machine->step_count_ != machine->condition_hit_step_ &&
+        checkConditionBreakpoints(machine, rule_index))
+    {
+      machine->condition_hit_step_ = machine->step_count_;
+      break;
+    }
+
+    if (executeRule(machine, rule_index))
+      break;
+
+    //no counter of its own, the step count passed a multiple of the interval
+    if ((machine->step_count_ & (EXECUTION_CHECK_INTERVAL - 1)) <
+          rule->step_weight_ && machine->execution_)
+    {
+      publishExecutionProgress(machine);
+      if (atomic_load_explicit(&execution_stop_requested,
+                               memory_order_relaxed))
+      {
+        atomic_store(&machine->execution_->paused_, TRUE);
+        break;
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check int Breakpoints.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param type Type of the Breakpoint to be check.
+/// @param value Value to be check.
+/// @return Boolean (TRUE) - checkpoint exists
+///         Boolean (FALSE) - checkpoint doesn't exist
+//
+Boolean checkIntBreakpoints(Turing* machine, char* type, int value)
+{
+  Boolean return_value = FALSE;
+
+  int breakpoints_counter = 0;
+  int breakpoints_length = machine->breakpoint_counter_;
+
+  for (; breakpoints_counter < breakpoints_length; breakpoints_counter++)
+  {
+    if (strcmp(machine->breakpoints_[breakpoints_counter].type_, type) == 0)
+      if (machine->breakpoints_[breakpoints_counter].value_ == value)
+      {
+        return_value = TRUE;
+        machine->breakpoints_[breakpoints_counter].value_ =
+          BREAKPOINT_DISARMED;
+      }
+  }
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check char Breakpoints.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param type Type of the Breakpoint to be check.
+/// @param symbol Symbol to be check.
+/// @return Boolean (TRUE) - checkpoint exists
+///         Boolean (FALSE) - checkpoint doesn't exist
+//
+Boolean checkCharBreakpoints(Turing* machine, char* type, char symbol)
+{
+  Boolean return_value = FALSE;
+
+  int breakpoints_counter = 0;
+  int breakpoints_length = machine->breakpoint_counter_;
+
+  for (; breakpoints_counter < breakpoints_length; breakpoints_counter++)
+    if (strcmp(machine->breakpoints_[breakpoints_counter].type_, type) == 0)
+      if (machine->breakpoints_[breakpoints_counter].value_ == symbol)
+      {
+        return_value = TRUE;
+        machine->breakpoints_[breakpoints_counter].value_ =
+          BREAKPOINT_DISARMED;
+      }
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to set a Breakpoint.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param type Type of the Breakpoint to be set.
+/// @param value Value of the Breakpoint to be set.
+//
+int setBreakPoint(Turing* machine, char* type, char* value) //TODO Reallocate if breakpoints > Breakpointslimit
+{
+  if (type && value)
+  {
+    int int_value = 0;
+    Boolean is_valide_type = FALSE;
+
+    if (strcmp(type, "write") == 0 || strcmp(type, "read") == 0)
+      is_valide_type = TRUE;
+    else if (strcmp(type, "state") == 0 || strcmp(type, "pos") == 0)
+      is_valide_type = parseInteger(value, &int_value) &&
+                       int_value != BREAKPOINT_DISARMED;
+
+    if (is_valide_type)
+    {
+      int breakpoint_pos = machine->breakpoint_counter_;
+      machine->breakpoint_counter_++;
+      machine->breakpoints_[breakpoint_pos].type_ = calloc(6, sizeof(char));
+      if(!(machine->breakpoints_[breakpoint_pos].type_))
+      {
+        free(machine->breakpoints_[breakpoint_pos].type_);
+        machine->breakpoints_[breakpoint_pos].type_ = NULL;
+        printf(OUT_OF_MEMORY);
+        return ERROR_CODE_OUT_OF_MEMORY;
+      }
+
+      sprintf(machine->breakpoints_[breakpoint_pos].type_, "%s", type);
+      if (strcmp(type, "state") == 0 || strcmp(type, "pos") == 0)
+        machine->breakpoints_[breakpoint_pos].value_ = int_value;
+      else
+        machine->breakpoints_[breakpoint_pos].value_ = value[0];
+    }
+  }
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Appends one instruction to the compiled condition and keeps track of the
+/// stack depth the instruction needs at evaluation.
+///
+/// @param parser The state of the condition compiler.
+/// @param operation Operation of the instruction.
+/// @param operand Operand of the instruction (constant, variable or target).
+/// @return int Index of the appended instruction
+//
+int emitCondition(ConditionParser* parser, ConditionOperation operation,
+                  long long operand)
+{
+  ConditionCode* code = NULL;
+
+  if (parser->failed_)
+    return 0;
+
+  if (parser->code_length_ >= parser->code_limit_)
+  {
+    parser->code_limit_ = parser->code_limit_ ? parser->code_limit_ * 2 : 16;
+    code = realloc(parser->code_, parser->code_limit_ * sizeof(ConditionCode));
+    if (!code)
+    {
+      parser->failed_ = TRUE;
+      parser->out_of_memory_ = TRUE;
+      return 0;
+    }
+    parser->code_ = code;
+  }
+
+  if (operation == CONDITION_PUSH || operation == CONDITION_LOAD)
+    parser->depth_++;
+  else if (operation != CONDITION_NOT && operation != CONDITION_NEGATE &&
+           operation != CONDITION_TO_BOOLEAN)
+    parser->depth_--;
+  if (parser->depth_ > parser->max_depth_)
+    parser->max_depth_ = parser->depth_;
+  if (parser->max_depth_ > CONDITION_STACK_SIZE)
+    parser->failed_ = TRUE;
+
+  parser->code_[parser->code_length_].operation_ = operation;
+  parser->code_[parser->code_length_].operand_ = operand;
+  return parser->code_length_++;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Skips whitespace and checks whether the condition continues with the
+/// given token. The token is consumed if it matches.
+///
+/// @param parser The state of the condition compiler.
+/// @param token The expected token.
+/// @return Boolean (TRUE) - token matched and was consumed
+///         Boolean (FALSE) - token did not match
+//
+Boolean acceptConditionToken(ConditionParser* parser, char* token)
+{
+  int token_length = strlen(token);
+
+  while (isspace((unsigned char)*parser->cursor_))
+    parser->cursor_++;
+
+  if (strncmp(parser->cursor_, token, token_length) != 0)
+    return FALSE;
+
+  //'<' must not match the start of "<=", '=' never stands alone
+  if (token_length == 1 && strchr("<>!", token[0]) &&
+      parser->cursor_[1] == '=')
+    return FALSE;
+
+  parser->cursor_ += token_length;
+  return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compiles a primary expression: a number, a quoted symbol, a variable, or
+/// a parenthesized or unary expression.
+///
+/// @param parser The state of the condition compiler.
+//
+void compileConditionPrimary(ConditionParser* parser)
+{
+  static char* variables[] = {"state", "read", "write", "pos", "steps",
+                              "next", "move", "rule"};
+  int variable_counter = 0;
+
+  if (acceptConditionToken(parser, "("))
+  {
+    compileConditionOr(parser);
+    if (!acceptConditionToken(parser, ")"))
+      parser->failed_ = TRUE;
+  }
+  else if (acceptConditionToken(parser, "!"))
+  {
+    compileConditionPrimary(parser);
+    emitCondition(parser, CONDITION_NOT, 0);
+  }
+  else if (acceptConditionToken(parser, "-"))
+  {
+    compileConditionPrimary(parser);
+    emitCondition(parser, CONDITION_NEGATE, 0);
+  }
+  else if (parser->cursor_[0] == '\'' && parser->cursor_[1] &&
+           parser->cursor_[2] == '\'')
+  {
+    emitCondition(parser, CONDITION_PUSH, parser->cursor_[1]);
+    parser->cursor_ += 3;
+  }
+  else if (isdigit((unsigned char)*parser->cursor_))
+  {
+    char* end = NULL;
+    errno = 0;
+    long long value = strtoll(parser->cursor_, &end, 10);
+    if (errno == ERANGE)
+      parser->failed_ = TRUE;
+    emitCondition(parser, CONDITION_PUSH, value);
+    parser->cursor_ = end;
+  }
+  else
+  {
+    for (; variable_counter < CONDITION_VARIABLE_COUNT; variable_counter++)
+    {
+      int name_length = strlen(variables[variable_counter]);
+      if (strncmp(parser->cursor_, variables[variable_counter],
+                  name_length) == 0 &&
+          !isalnum((unsigned char)parser->cursor_[name_length]) &&
+          parser->cursor_[name_length] != '_')
+      {
+        emitCondition(parser, CONDITION_LOAD, variable_counter);
+        parser->cursor_ += name_length;
+        return;
+      }
+    }
+    parser->failed_ = TRUE;
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compiles a chain of '*', '/' and '%' operations.
+///
+/// @param parser The state of the condition compiler.
+//
+void compileConditionProduct(ConditionParser* parser)
+{
+  compileConditionPrimary(parser);
+  while (!parser->failed_)
+  {
+    if (acceptConditionToken(parser, "*"))
+    {
+      compileConditionPrimary(parser);
+      emitCondition(parser, CONDITION_MULTIPLY, 0);
+    }
+    else if (acceptConditionToken(parser, "/"))
+    {
+      compileConditionPrimary(parser);
+      emitCondition(parser, CONDITION_DIVIDE, 0);
+    }
+    else if (acceptConditionToken(parser, "%"))
+    {
+      compileConditionPrimary(parser);
+      emitCondition(parser, CONDITION_MODULO, 0);
+    }
+    else
+      break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compiles a chain of '+' and '-' operations.
+///
+/// @param parser The state of the condition compiler.
+//
+void compileConditionSum(ConditionParser* parser)
+{
+  compileConditionProduct(parser);
+  while (!parser->failed_)
+  {
+    if (acceptConditionToken(parser, "+"))
+    {
+      compileConditionProduct(parser);
+      emitCondition(parser, CONDITION_ADD, 0);
+    }
+    else if (acceptConditionToken(parser, "-"))
+    {
+      compileConditionProduct(parser);
+      emitCondition(parser, CONDITION_SUBTRACT, 0);
+    }
+    else
+      break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compiles a comparison (==, !=, <, <=, >, >=) or a single sum.
+///
+/// @param parser The state of the condition compiler.
+//
+void compileConditionComparison(ConditionParser* parser)
+{
+  static char* operators[] = {"==", "!=", "<=", ">=", "<", ">"};
+  static ConditionOperation operations[] = {CONDITION_EQUAL,
+    CONDITION_NOT_EQUAL, CONDITION_LESS_EQUAL, CONDITION_GREATER_EQUAL,
+    CONDITION_LESS, CONDITION_GREATER};
+  int operator_counter = 0;
+
+  compileConditionSum(parser);
+  for (; operator_counter < 6 && !parser->failed_; operator_counter++)
+  {
+    if (acceptConditionToken(parser, operators[operator_counter]))
+    {
+      compileConditionSum(parser);
+      emitCondition(parser, operations[operator_counter], 0);
+      break;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compiles a chain of '&&' operations. The right side is skipped as soon
+/// as the left side is false.
+///
+/// @param parser The state of the condition compiler.
+//
+void compileConditionAnd(ConditionParser* parser)
+{
+  compileConditionComparison(parser);
+  while (!parser->failed_ && acceptConditionToken(parser, "&&"))
+  {
+    int jump = emitCondition(parser, CONDITION_AND_JUMP, 0);
+    compileConditionComparison(parser);
+    emitCondition(parser, CONDITION_TO_BOOLEAN, 0);
+    if (!parser->failed_)
+      parser->code_[jump].operand_ = parser->code_length_;
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compiles a chain of '||' operations. The right side is skipped as soon
+/// as the left side is true.
+///
+/// @param parser The state of the condition compiler.
+//
+void compileConditionOr(ConditionParser* parser)
+{
+  compileConditionAnd(parser);
+  while (!parser->failed_ && acceptConditionToken(parser, "||"))
+  {
+    int jump = emitCondition(parser, CONDITION_OR_JUMP, 0);
+    compileConditionAnd(parser);
+    emitCondition(parser, CONDITION_TO_BOOLEAN, 0);
+    if (!parser->failed_)
+      parser->code_[jump].operand_ = parser->code_length_;
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to set a conditional breakpoint. The condition is compiled once
+/// into a small stack bytecode which is evaluated before every step.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param expression The condition of the breakpoint.
+/// @param one_shot TRUE if the breakpoint is deleted after the first hit.
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int setConditionBreakpoint(Turing* machine, char* expression, Boolean one_shot)
+{
+  ConditionParser parser = {expression, NULL, 0, 0, 0, 0, FALSE, FALSE};
+  ConditionBreakpoint* conditions = NULL;
+  ConditionBreakpoint* condition = NULL;
+
+  compileConditionOr(&parser);
+  while (isspace((unsigned char)*parser.cursor_))
+    parser.cursor_++;
+  if (*parser.cursor_ != '\0')
+    parser.failed_ = TRUE;
+
+  if (parser.failed_)
+  {
+    free(parser.code_);
+    if (parser.out_of_memory_)
+    {
+      printf(OUT_OF_MEMORY);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
+    printf(INVALID_CONDITION);
+    return EVERYTHING_WORKED_FINE;
+  }
+
+  conditions = realloc(machine->conditions_,
+                       (machine->condition_counter_ + 1) *
+                       sizeof(ConditionBreakpoint));
+  if (!conditions)
+  {
+    free(parser.code_);
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+  machine->conditions_ = conditions;
+
+  condition = &conditions[machine->condition_counter_];
+  condition->expression_ = malloc(strlen(expression) + 1);
+  if (!condition->expression_)
+  {
+    free(parser.code_);
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+  strcpy(condition->expression_, expression);
+  condition->code_ = parser.code_;
+  condition->code_length_ = parser.code_length_;
+  condition->hits_ = 0;
+  condition->ignore_count_ = 0;
+  condition->one_shot_ = one_shot;
+  machine->condition_counter_++;
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to delete a conditional breakpoint.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param index Index of the breakpoint (starting with 0).
+//
+void removeConditionBreakpoint(Turing* machine, int index)
+{
+  free(machine->conditions_[index].expression_);
+  free(machine->conditions_[index].code_);
+  memmove(&machine->conditions_[index], &machine->conditions_[index + 1],
+          (machine->condition_counter_ - index - 1) *
+          sizeof(ConditionBreakpoint));
+  machine->condition_counter_--;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to display all conditional breakpoints with their hit counts.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void listConditionBreakpoints(Turing* machine)
+{
+  int condition_counter = 0;
+
+  for (; condition_counter < machine->condition_counter_; condition_counter++)
+  {
+    ConditionBreakpoint* condition = &machine->conditions_[condition_counter];
+    printf("%i: %s if %s (hits %lli", condition_counter + 1,
+           condition->one_shot_ ? "tbreak" : "break", condition->expression_,
+           condition->hits_);
+    if (condition->ignore_count_ > 0)
+      printf(", ignore next %i", condition->ignore_count_);
+    printf(")\n");
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Evaluates a compiled condition.
+///
+/// @param condition The conditional breakpoint.
+/// @param variables Values of all condition variables for the current step.
+/// @return long long The value of the condition
+//
+long long evaluateCondition(ConditionBreakpoint* condition,
+                            long long* variables)
+{
+  long long stack[CONDITION_STACK_SIZE];
+  int top = -1;
+  int code_counter = 0;
+
+  while (code_counter < condition->code_length_)
+  {
+    ConditionCode* code = &condition->code_[code_counter++];
+    switch (code->operation_)
+    {
+      case CONDITION_PUSH:
+        stack[++top] = code->operand_;
+        break;
+      case CONDITION_LOAD:
+        stack[++top] = variables[code->operand_];
+        break;
+      case CONDITION_NOT:
+        stack[top] = !stack[top];
+        break;
+      case CONDITION_NEGATE:
+        stack[top] = -stack[top];
+        break;
+      case CONDITION_TO_BOOLEAN:
+        stack[top] = stack[top] != 0;
+        break;
+      case CONDITION_AND_JUMP:
+        if (!stack[top])
+          code_counter = code->operand_;
+        else
+          top--;
+        break;
+      case CONDITION_OR_JUMP:
+        if (stack[top])
+        {
+          stack[top] = 1;
+          code_counter = code->operand_;
+        }
+        else
+          top--;
+        break;
+      case CONDITION_ADD:
+        top--;
+        stack[top] += stack[top + 1];
+        break;
+      case CONDITION_SUBTRACT:
+        top--;
+        stack[top] -= stack[top + 1];
+        break;
+      case CONDITION_MULTIPLY:
+        top--;
+        stack[top] *= stack[top + 1];
+        break;
+      case CONDITION_DIVIDE:
+        top--;
+        stack[top] = stack[top + 1] ? stack[top] / stack[top + 1] : 0;
+        break;
+      case CONDITION_MODULO:
+        top--;
+        stack[top] = stack[top + 1] ? stack[top] % stack[top + 1] : 0;
+        break;
+      case CONDITION_EQUAL:
+        top--;
+        stack[top] = stack[top] == stack[top + 1];
+        break;
+      case CONDITION_NOT_EQUAL:
+        top--;
+        stack[top] = stack[top] != stack[top + 1];
+        break;
+      case CONDITION_LESS:
+        top--;
+        stack[top] = stack[top] < stack[top + 1];
+        break;
+      case CONDITION_LESS_EQUAL:
+        top--;
+        stack[top] = stack[top] <= stack[top + 1];
+        break;
+      case CONDITION_GREATER:
+        top--;
+        stack[top] = stack[top] > stack[top + 1];
+        break;
+      case CONDITION_GREATER_EQUAL:
+        top--;
+        stack[top] = stack[top] >= stack[top + 1];
+        break;
+    }
+  }
+
+  return stack[0];
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check the conditional breakpoints before a step. The step
+/// variables are collected once and shared by all conditions.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param rule_index Index of the rule which is executed next.
+/// @return Boolean (TRUE) - a breakpoint was hit
+///         Boolean (FALSE) - no breakpoint was hit
+//
+Boolean checkConditionBreakpoints(Turing* machine, int rule_index)
+{
+  int condition_counter = 0;
+  Boolean return_value = FALSE;
+  Rules* rule = &machine->rules_[rule_index];
+  long long variables[CONDITION_VARIABLE_COUNT];
+
+  variables[CONDITION_VARIABLE_STATE] = machine->current_state_;
+  variables[CONDITION_VARIABLE_READ] =
+    machine->band_[machine->head_position_];
+  variables[CONDITION_VARIABLE_WRITE] = rule->symbol_to_write_;
+  variables[CONDITION_VARIABLE_POS] = machine->head_position_;
+  variables[CONDITION_VARIABLE_STEPS] = machine->step_count_;
+  variables[CONDITION_VARIABLE_NEXT] = rule->next_state_;
+  variables[CONDITION_VARIABLE_MOVE] = rule->head_movement_;
+  variables[CONDITION_VARIABLE_RULE] = rule_index;
+
+  while (condition_counter < machine->condition_counter_)
+  {
+    ConditionBreakpoint* condition = &machine->conditions_[condition_counter];
+
+    if (evaluateCondition(condition, variables))
+    {
+      condition->hits_++;
+      if (condition->ignore_count_ > 0)
+        condition->ignore_count_--;
+      else
+      {
+        printf("breakpoint %i: %s (hit %lli)\n", condition_counter + 1,
+               condition->expression_, condition->hits_);
+        return_value = TRUE;
+        if (condition->one_shot_)
+        {
+          removeConditionBreakpoint(machine, condition_counter);
+          continue;
+        }
+      }
+    }
+    condition_counter++;
+  }
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Builds the dense transition table (state index x symbol index -> rule)
+/// the optimizer passes work on. The alphabet contains every symbol which
+/// can ever be under the head: the blank, the symbols of the band and all
+/// symbols read or written by a rule.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param table The table to be built.
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int buildRuleTable(Turing* machine, RuleTable* table)
+{
+  int rules_counter = 0;
+  int state_counter = 0;
+  int band_position = 0;
+  int band_length = machine->band_capacity_;
+
+  memset(table, 0, sizeof(RuleTable));
+  memset(table->symbol_index_, -1, sizeof(table->symbol_index_));
+
+  table->symbol_index_['_'] = table->symbol_count_++;
+  for (; band_position < band_length; band_position++)
+    if (table->symbol_index_[(unsigned char)
+                             machine->band_memory_[band_position]] < 0)
+      table->symbol_index_[(unsigned char)
+                           machine->band_memory_[band_position]] =
+        table->symbol_count_++;
+
+  table->states_ = malloc((2 * machine->rules_count_ + 1) * sizeof(int));
+  if (!table->states_)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  table->states_[table->state_count_++] = machine->start_state_;
+  for (; rules_counter < machine->rules_count_; rules_counter++)
+  {
+    Rules* rule = &machine->rules_[rules_counter];
+    table->states_[table->state_count_++] = rule->current_state_;
+    table->states_[table->state_count_++] = rule->next_state_;
+    if (table->symbol_index_[(unsigned char)rule->readed_symbol_] < 0)
+      table->symbol_index_[(unsigned char)rule->readed_symbol_] =
+        table->symbol_count_++;
+    if (table->symbol_index_[(unsigned char)rule->symbol_to_write_] < 0)
+      table->symbol_index_[(unsigned char)rule->symbol_to_write_] =
+        table->symbol_count_++;
+  }
+
+  qsort(table->states_, table->state_count_, sizeof(int), compareIntegers);
+  for (rules_counter = 0; rules_counter < table->state_count_; rules_counter++)
+    if (state_counter == 0 ||
+        table->states_[state_counter - 1] != table->states_[rules_counter])
+      table->states_[state_counter++] = table->states_[rules_counter];
+  table->state_count_ = state_counter;
+
+  table->transitions_ = malloc((size_t)table->state_count_ *
+                               table->symbol_count_ * sizeof(int));
+  if (!table->transitions_)
+  {
+    free(table->states_);
+    table->states_ = NULL;
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+  memset(table->transitions_, -1, (size_t)table->state_count_ *
+                                  table->symbol_count_ * sizeof(int));
+
+  for (rules_counter = 0; rules_counter < machine->rules_count_;
+       rules_counter++)
+  {
+    Rules* rule = &machine->rules_[rules_counter];
+    table->transitions_[stateIndex(table, rule->current_state_) *
+                        table->symbol_count_ +
+                        table->symbol_index_[(unsigned char)
+                                             rule->readed_symbol_]] =
+      rules_counter;
+  }
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Frees the arrays of a table built by buildRuleTable().
+///
+/// @param table The table to be freed.
+//
+void freeRuleTable(RuleTable* table)
+{
+  free(table->states_);
+  table->states_ = NULL;
+  free(table->transitions_);
+  table->transitions_ = NULL;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compares two integers for qsort() and bsearch().
+///
+/// @param first Pointer to the first integer.
+/// @param second Pointer to the second integer.
+/// @return int <0, 0 or >0 like strcmp()
+//
+int compareIntegers(const void* first, const void* second)
+{
+  int first_value = *(const int*)first;
+  int second_value = *(const int*)second;
+
+  return (first_value > second_value) - (first_value < second_value);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Looks up the dense index of a state.
+///
+/// @param table The rule table.
+/// @param state The state number.
+/// @return int Index of the state inside the table
+//
+int stateIndex(RuleTable* table, int state)
+{
+  int* found = bsearch(&state, table->states_, table->state_count_,
+                       sizeof(int), compareIntegers);
+
+  return found - table->states_;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Checks whether a state has a rule for every symbol of the alphabet, so
+/// the machine can never halt in it.
+///
+/// @param table The rule table.
+/// @param state_index Index of the state.
+/// @return Boolean (TRUE) - all symbols have a rule
+///         Boolean (FALSE) - the machine may halt in this state
+//
+Boolean isStateComplete(RuleTable* table, int state_index)
+{
+  int symbol_counter = 0;
+
+  for (; symbol_counter < table->symbol_count_; symbol_counter++)
+    if (table->transitions_[state_index * table->symbol_count_ +
+                            symbol_counter] < 0)
+      return FALSE;
+
+  return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Removes all rules which are not reachable from the start state. The
+/// rules keep their order.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int pruneUnreachableStates(Turing* machine)
+{
+  int queue_head = 0;
+  int queue_length = 0;
+  int rules_counter = 0;
+  int kept_rules = 0;
+  int* queue = NULL;
+  char* reachable = NULL;
+  RuleTable table;
+
+  if (buildRuleTable(machine, &table) != EVERYTHING_WORKED_FINE)
+    return ERROR_CODE_OUT_OF_MEMORY;
+
+  queue = malloc(table.state_count_ * sizeof(int));
+  reachable = calloc(table.state_count_, sizeof(char));
+  if (!queue || !reachable)
+  {
+    free(queue);
+    free(reachable);
+    freeRuleTable(&table);
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  queue[queue_length++] = stateIndex(&table, machine->start_state_);
+  reachable[queue[0]] = TRUE;
+  while (queue_head < queue_length)
+  {
+    int state_index = queue[queue_head++];
+    int symbol_counter = 0;
+    for (; symbol_counter < table.symbol_count_; symbol_counter++)
+    {
+      int rule_index = table.transitions_[state_index * table.symbol_count_ +
+                                          symbol_counter];
+      if (rule_index >= 0)
+      {
+        int next_index = stateIndex(&table,
+                                    machine->rules_[rule_index].next_state_);
+        if (!reachable[next_index])
+        {
+          reachable[next_index] = TRUE;
+          queue[queue_length++] = next_index;
+        }
+      }
+    }
+  }
+
+  for (; rules_counter < machine->rules_count_; rules_counter++)
+    if (reachable[stateIndex(&table,
+                             machine->rules_[rules_counter].current_state_)])
+      machine->rules_[kept_rules++] = machine->rules_[rules_counter];
+  //the unfused copy stays right behind the rules
+  memmove(&machine->rules_[kept_rules], &machine->rules_[rules_counter],
+          machine->unfused_rules_count_ * sizeof(Rules));
+  machine->rules_count_ = kept_rules;
+
+  free(queue);
+  free(reachable);
+  freeRuleTable(&table);
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Compares the signatures of two states for qsort() during the partition
+/// refinement.
+///
+/// @param first Pointer to the signature of the first state.
+/// @param second Pointer to the signature of the second state.
+/// @return int <0, 0 or >0 like strcmp()
+//
+int compareStateSignatures(const void* first, const void* second)
+{
+  const StateSignature* first_state = first;
+  const StateSignature* second_state = second;
+
+  return memcmp(first_state->signature_, second_state->signature_,
+                first_state->length_ * sizeof(int));
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Merges equivalent states by partition refinement. States in which the
+/// machine may halt stay on their own, so the final state is not changed.
+/// All other states start in one block which is split until all states of
+/// a block write and move alike and continue into the same blocks.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int mergeEquivalentStates(Turing* machine)
+{
+  int state_counter = 0;
+  int rules_counter = 0;
+  int kept_rules = 0;
+  int block_count = 0;
+  int previous_block_count = -1;
+  int signature_length = 0;
+  int* signatures = NULL;
+  int* blocks = NULL;
+  StateSignature* order = NULL;
+  int* representatives = NULL;
+  RuleTable table;
+
+  if (buildRuleTable(machine, &table) != EVERYTHING_WORKED_FINE)
+    return ERROR_CODE_OUT_OF_MEMORY;
+
+  signature_length = 1 + 3 * table.symbol_count_;
+  signatures = malloc((size_t)table.state_count_ * signature_length *
+                      sizeof(int));
+  blocks = malloc(table.state_count_ * sizeof(int));
+  order = malloc(table.state_count_ * sizeof(StateSignature));
+  representatives = malloc(table.state_count_ * sizeof(int));
+  if (!signatures || !blocks || !order || !representatives)
+  {
+    free(signatures);
+    free(blocks);
+    free(order);
+    free(representatives);
+    freeRuleTable(&table);
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  block_count = 1;
+  for (; state_counter < table.state_count_; state_counter++)
+    blocks[state_counter] = isStateComplete(&table, state_counter) ?
+                            0 : block_count++;
+
+  while (block_count != previous_block_count)
+  {
+    previous_block_count = block_count;
+    for (state_counter = 0; state_counter < table.state_count_;
+         state_counter++)
+    {
+      int* signature = signatures + state_counter * signature_length;
+      int symbol_counter = 0;
+
+      signature[0] = blocks[state_counter];
+      for (; symbol_counter < table.symbol_count_; symbol_counter++)
+      {
+        int rule_index = table.transitions_[state_counter *
+                                            table.symbol_count_ +
+                                            symbol_counter];
+        Rules* rule = rule_index >= 0 ? &machine->rules_[rule_index] : NULL;
+        signature[1 + 3 * symbol_counter] = rule ? rule->symbol_to_write_ : -1;
+        signature[2 + 3 * symbol_counter] = rule ? rule->move_distance_ : 0;
+        signature[3 + 3 * symbol_counter] = rule ?
+          blocks[stateIndex(&table, rule->next_state_)] : -1;
+      }
+      order[state_counter].signature_ = signature;
+      order[state_counter].length_ = signature_length;
+      order[state_counter].state_index_ = state_counter;
+    }
+
+    qsort(order, table.state_count_, sizeof(StateSignature),
+          compareStateSignatures);
+    block_count = 0;
+    for (state_counter = 0; state_counter < table.state_count_;
+         state_counter++)
+    {
+      if (state_counter == 0 ||
+          compareStateSignatures(&order[state_counter - 1],
+                                 &order[state_counter]) != 0)
+        block_count++;
+      representatives[order[state_counter].state_index_] = block_count - 1;
+    }
+    memcpy(blocks, representatives, table.state_count_ * sizeof(int));
+  }
+
+  //every block is represented by its lowest state, or by the start state
+  for (state_counter = 0; state_counter < block_count; state_counter++)
+    representatives[state_counter] = INT_MIN;
+  representatives[blocks[stateIndex(&table, machine->start_state_)]] =
+    machine->start_state_;
+  for (state_counter = 0; state_counter < table.state_count_; state_counter++)
+    if (representatives[blocks[state_counter]] == INT_MIN ||
+        (representatives[blocks[state_counter]] != machine->start_state_ &&
+         table.states_[state_counter] <
+           representatives[blocks[state_counter]]))
+      representatives[blocks[state_counter]] = table.states_[state_counter];
+
+  for (; rules_counter < machine->rules_count_; rules_counter++)
+  {
+    Rules* rule = &machine->rules_[rules_counter];
+    if (representatives[blocks[stateIndex(&table, rule->current_state_)]] ==
+        rule->current_state_)
+    {
+      rule->next_state_ =
+        representatives[blocks[stateIndex(&table, rule->next_state_)]];
+      machine->rules_[kept_rules++] = *rule;
+    }
+  }
+  machine->rules_count_ = kept_rules;
+
+  free(signatures);
+  free(blocks);
+  free(order);
+  free(representatives);
+  freeRuleTable(&table);
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Fuses chains of pure-move states into the rules leading into them. A
+/// pure-move state has a rule for every symbol, writes back what it reads
+/// and moves the same way into the same next state. Such a rule becomes a
+/// multi-cell move which counts as all the steps it replaces. The rules as
+/// they were before are kept behind the fused rules, so the steps of a
+/// fused rule can still be executed one by one.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int fusePureMoveStates(Turing* machine)
+{
+  int state_counter = 0;
+  int rules_counter = 0;
+  int* pure_distances = NULL;
+  int* pure_targets = NULL;
+  Boolean has_pure_states = FALSE;
+  RuleTable table;
+
+  if (buildRuleTable(machine, &table) != EVERYTHING_WORKED_FINE)
+    return ERROR_CODE_OUT_OF_MEMORY;
+
+  pure_distances = calloc(table.state_count_, sizeof(int));
+  pure_targets = malloc(table.state_count_ * sizeof(int));
+  if (!pure_distances || !pure_targets)
+  {
+    free(pure_distances);
+    free(pure_targets);
+    freeRuleTable(&table);
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  for (; state_counter < table.state_count_; state_counter++)
+  {
+    int symbol_counter = 0;
+    Rules* first_rule = NULL;
+    Boolean is_pure = isStateComplete(&table, state_counter);
+
+    for (; symbol_counter < table.symbol_count_ && is_pure; symbol_counter++)
+    {
+      Rules* rule = &machine->rules_[table.transitions_[state_counter *
+                                       table.symbol_count_ + symbol_counter]];
+      if (!first_rule)
+        first_rule = rule;
+      if (rule->symbol_to_write_ != rule->readed_symbol_ ||
+          rule->step_weight_ != 1 || rule->move_distance_ == 0 ||
+          rule->move_distance_ != first_rule->move_distance_ ||
+          rule->next_state_ != first_rule->next_state_ ||
+          rule->next_state_ == rule->current_state_)
+        is_pure = FALSE;
+    }
+
+    if (is_pure)
+    {
+      pure_distances[state_counter] = first_rule->move_distance_;
+      pure_targets[state_counter] = first_rule->next_state_;
+      has_pure_states = TRUE;
+    }
+  }
+
+  if (has_pure_states)
+  {
+    Rules* rules = realloc(machine->rules_,
+                           2 * machine->rules_count_ * sizeof(Rules));
+    if (!rules)
+    {
+      free(pure_distances);
+      free(pure_targets);
+      freeRuleTable(&table);
+      printf(OUT_OF_MEMORY);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
+    memcpy(rules + machine->rules_count_, rules,
+           machine->rules_count_ * sizeof(Rules));
+    machine->rules_ = rules;
+    machine->unfused_rules_count_ = machine->rules_count_;
+  }
+
+  for (; rules_counter < machine->rules_count_; rules_counter++)
+  {
+    Rules* rule = &machine->rules_[rules_counter];
+    int next_index = stateIndex(&table, rule->next_state_);
+    int chain_length = 0;
+
+    //a cycle of pure-move states never ends, so the chain is cut there
+    while (pure_distances[next_index] != 0 &&
+           chain_length < table.state_count_)
+    {
+      rule->move_distance_ += pure_distances[next_index];
+      rule->step_weight_++;
+      rule->next_state_ = pure_targets[next_index];
+      next_index = stateIndex(&table, rule->next_state_);
+      chain_length++;
+    }
+
+    if (chain_length > 0)
+      rule->head_movement_ = rule->move_distance_ > 0 ? 'R' :
+                             (rule->move_distance_ < 0 ? 'L' : '0');
+  }
+
+  free(pure_distances);
+  free(pure_targets);
+  freeRuleTable(&table);
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Optimizes the rules before the execution: prunes unreachable states,
+/// merges equivalent states and fuses pure-move chains. The final band, the
+/// final state and the step count stay the same as without optimization.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int optimizeRules(Turing* machine)
+{
+  int rules_before = machine->rules_count_;
+  int return_value = pruneUnreachableStates(machine);
+
+  if (return_value == EVERYTHING_WORKED_FINE)
+    return_value = mergeEquivalentStates(machine);
+  if (return_value == EVERYTHING_WORKED_FINE)
+    return_value = fusePureMoveStates(machine);
+  if (return_value == EVERYTHING_WORKED_FINE)
+    return_value = pruneUnreachableStates(machine);
+
+  if (return_value == EVERYTHING_WORKED_FINE)
+    printf("optimized %i rules to %i rules\n", rules_before,
+           machine->rules_count_);
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check whether the given character is a plus or a minus.
+///
+/// @param character The Character to be checked.
+/// @return Boolean (TRUE) - is a plus or a minus
+///         Boolean (FALSE) - is not a plus or a minus
+//
+Boolean isPlusOrMinus(char character)
+{
+  Boolean isPlusOrMinue = FALSE;
+	if (character == '-' || character == '+')
+      isPlusOrMinue = TRUE;
+
+	return isPlusOrMinue;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Parses a complete decimal integer (with optional sign).
+///
+/// @param text The text to be parsed.
+/// @param value The parsed value
+/// @return Boolean (TRUE) - text is a valid integer
+///         Boolean (FALSE) - text is not a valid integer
+//
+Boolean parseInteger(char* text, int* value)
+{
+  char* end = NULL;
+  long parsed_value = 0;
+
+  if (!text || !*text)
+    return FALSE;
+
+  errno = 0;
+  parsed_value = strtol(text, &end, 10);
+  if (*end != '\0' || errno == ERANGE ||
+      parsed_value < INT_MIN || parsed_value > INT_MAX)
+    return FALSE;
+
+  *value = (int)parsed_value;
+  return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Parses a complete decimal integer (with optional sign) which may be
+/// larger than an int, e.g. a number of steps.
+///
+/// @param text The text to be parsed.
+/// @param value The parsed value
+/// @return Boolean (TRUE) - text is a valid integer
+///         Boolean (FALSE) - text is not a valid integer
+//
+Boolean parseLongInteger(char* text, long long* value)
+{
+  char* end = NULL;
+  long long parsed_value = 0;
+
+  if (!text || !*text)
+    return FALSE;
+
+  errno = 0;
+  parsed_value = strtoll(text, &end, 10);
+  if (*end != '\0' || errno == ERANGE)
+    return FALSE;
+
+  *value = parsed_value;
+  return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to set a watchpoint over a range of the band.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param from First watched position.
+/// @param to Last watched position.
+/// @param type Type of the watchpoint (read, write or change), change if NULL
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int setWatchpoint(Turing* machine, char* from, char* to, char* type)
+{
+  int from_value = 0;
+  int to_value = 0;
+  WatchType watch_type = WATCH_CHANGE;
+  Watchpoint* watchpoints = NULL;
+
+  if (!parseInteger(from, &from_value) || !parseInteger(to, &to_value))
+    return EVERYTHING_WORKED_FINE;
+
+  if (!type || strcmp(type, "change") == 0)
+    watch_type = WATCH_CHANGE;
+  else if (strcmp(type, "write") == 0)
+    watch_type = WATCH_WRITE;
+  else if (strcmp(type, "read") == 0)
+    watch_type = WATCH_READ;
+  else
+    return EVERYTHING_WORKED_FINE;
+
+  watchpoints = realloc(machine->watchpoints_,
+                        (machine->watchpoint_counter_ + 1) *
+                        sizeof(Watchpoint));
+  if (!watchpoints)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+  machine->watchpoints_ = watchpoints;
+
+  if (from_value > to_value)
+  {
+    int swap_value = from_value;
+    from_value = to_value;
+    to_value = swap_value;
+  }
+  watchpoints[machine->watchpoint_counter_].from_ = from_value;
+  watchpoints[machine->watchpoint_counter_].to_ = to_value;
+  watchpoints[machine->watchpoint_counter_].type_ = watch_type;
+  machine->watchpoint_counter_++;
+
+  return updateWatchedPages(machine);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to remove a watchpoint.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param index Number of the watchpoint (starting with 1).
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int removeWatchpoint(Turing* machine, char* index)
+{
+  int watchpoint_index = 0;
+
+  if (!parseInteger(index, &watchpoint_index) || watchpoint_index < 1 ||
+      watchpoint_index > machine->watchpoint_counter_)
+    return EVERYTHING_WORKED_FINE;
+
+  memmove(&machine->watchpoints_[watchpoint_index - 1],
+          &machine->watchpoints_[watchpoint_index],
+          (machine->watchpoint_counter_ - watchpoint_index) *
+          sizeof(Watchpoint));
+  machine->watchpoint_counter_--;
+
+  return updateWatchedPages(machine);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to display all watchpoints with the numbers unwatch takes.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void listWatchpoints(Turing* machine)
+{
+  int watch_counter = 0;
+  char* type_names[] = {"read", "write", "change"};
+
+  for (; watch_counter < machine->watchpoint_counter_; watch_counter++)
+  {
+    Watchpoint* watchpoint = &machine->watchpoints_[watch_counter];
+    printf("%i: watch %i %i %s\n", watch_counter + 1, watchpoint->from_,
+           watchpoint->to_, type_names[watchpoint->type_]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Rebuilds the bitmap with one bit per page of the band which tells whether
+/// any watchpoint covers a cell of that page.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int updateWatchedPages(Turing* machine)
+{
+  int watch_counter = 0;
+  long long first_page = 0;
+  long long last_page = 0;
+  long long page_count = 0;
+  long long page = 0;
+
+  free(machine->watched_pages_);
+  machine->watched_pages_ = NULL;
+  machine->watched_base_ = 0;
+  machine->watched_span_ = 0;
+
+  if (machine->watchpoint_counter_ == 0)
+    return EVERYTHING_WORKED_FINE;
+
+  first_page = ((long long)INT_MAX >> WATCH_PAGE_SHIFT) + 1;
+  last_page = ((long long)INT_MIN >> WATCH_PAGE_SHIFT) - 1;
+  for (; watch_counter < machine->watchpoint_counter_; watch_counter++)
+  {
+    Watchpoint* watchpoint = &machine->watchpoints_[watch_counter];
+    if ((watchpoint->from_ >> WATCH_PAGE_SHIFT) < first_page)
+      first_page = watchpoint->from_ >> WATCH_PAGE_SHIFT;
+    if ((watchpoint->to_ >> WATCH_PAGE_SHIFT) > last_page)
+      last_page = watchpoint->to_ >> WATCH_PAGE_SHIFT;
+  }
+
+  //the bitmap never needs to cover more than the int range of positions
+  if (first_page < ((long long)INT_MIN >> WATCH_PAGE_SHIFT))
+    first_page = (long long)INT_MIN >> WATCH_PAGE_SHIFT;
+  if (last_page > ((long long)INT_MAX >> WATCH_PAGE_SHIFT))
+    last_page = (long long)INT_MAX >> WATCH_PAGE_SHIFT;
+
+  page_count = last_page - first_page + 1;
+  if (page_count < 1)
+    return EVERYTHING_WORKED_FINE;
+  machine->watched_pages_ = calloc((page_count >> 3) + 1,
+                                   sizeof(unsigned char));
+  if (!machine->watched_pages_)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  for (watch_counter = 0; watch_counter < machine->watchpoint_counter_;
+       watch_counter++)
+  {
+    Watchpoint* watchpoint = &machine->watchpoints_[watch_counter];
+    long long end_page = watchpoint->to_ >> WATCH_PAGE_SHIFT;
+
+    page = watchpoint->from_ >> WATCH_PAGE_SHIFT;
+    for (; page <= end_page; page++)
+      machine->watched_pages_[(page - first_page) >> 3] |=
+        1 << ((page - first_page) & 7);
+  }
+
+  machine->watched_base_ = (int)(first_page << WATCH_PAGE_SHIFT);
+  if ((page_count << WATCH_PAGE_SHIFT) > UINT_MAX)
+    machine->watched_span_ = UINT_MAX;
+  else
+    machine->watched_span_ = page_count << WATCH_PAGE_SHIFT;
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check whether the page of the given position is watched.
+/// This is the only watchpoint check on the path of every step.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param position Position of the band to be checked.
+/// @return Boolean (TRUE) - page of the position is watched
+///         Boolean (FALSE) - page of the position is not watched
+//
+Boolean isPageWatched(Turing* machine, int position)
+{
+  unsigned int offset = (unsigned int)position -
+                        (unsigned int)machine->watched_base_;
+
+  return offset < machine->watched_span_ &&
+         (machine->watched_pages_[offset >> (WATCH_PAGE_SHIFT + 3)] &
+          (1 << ((offset >> WATCH_PAGE_SHIFT) & 7)));
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Function to check all watchpoints against the executed step and to
+/// display the ones which were hit.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @param position Position the step was executed at.
+/// @param read Symbol which was read at the position.
+/// @param written Symbol which was written at the position.
+/// @return Boolean (TRUE) - at least one watchpoint was hit
+///         Boolean (FALSE) - no watchpoint was hit
+//
+Boolean checkWatchpoints(Turing* machine, int position, char read, char written)
+{
+  int watch_counter = 0;
+  Boolean return_value = FALSE;
+
+  for (; watch_counter < machine->watchpoint_counter_; watch_counter++)
+  {
+    Watchpoint* watchpoint = &machine->watchpoints_[watch_counter];
+
+    if (position < watchpoint->from_ || position > watchpoint->to_)
+      continue;
+
+    if (watchpoint->type_ == WATCH_READ)
+    {
+      printf("watchpoint %i: read %c at pos %i\n", watch_counter + 1, read,
+             position);
+      return_value = TRUE;
+    }
+    else if (watchpoint->type_ == WATCH_WRITE || read != written)
+    {
+      printf("watchpoint %i: %c -> %c at pos %i\n", watch_counter + 1,
+             read, written, position);
+      return_value = TRUE;
+    }
+  }
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Packs an unsigned value as a little endian base-128 varint.
+///
+/// @param buffer Buffer the varint is written to (at least 10 bytes)
+/// @param value Value to be packed.
+/// @return int Number of bytes written to the buffer
+//
+int packVarint(unsigned char* buffer, unsigned long long value)
+{
+  int bytes_written = 0;
+
+  while (value >= 0x80)
+  {
+    buffer[bytes_written++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  buffer[bytes_written++] = (unsigned char)value;
+
+  return bytes_written;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Unpacks a varint which was written by packVarint().
+///
+/// @param cursor Read position inside the buffer, moved behind the varint
+/// @param end First byte behind the buffer
+/// @param value The unpacked value
+/// @return Boolean (TRUE) - varint successfully unpacked
+///         Boolean (FALSE) - buffer ended inside the varint
+//
+Boolean unpackVarint(unsigned char** cursor, unsigned char* end,
+                     unsigned long long* value)
+{
+  int shift = 0;
+  *value = 0;
+
+  while (*cursor < end && shift < 64)
+  {
+    unsigned char byte = *(*cursor)++;
+    *value |= (unsigned long long)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return TRUE;
+    shift += 7;
+  }
+
+  return FALSE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Reads a varint which was written by packVarint() from a file.
+///
+/// @param file The file to read from
+/// @param value The read value
+/// @return Boolean (TRUE) - varint successfully read
+///         Boolean (FALSE) - end of file or broken varint
+//
+Boolean readVarint(FILE* file, unsigned long long* value)
+{
+  int shift = 0;
+  int character = 0;
+  *value = 0;
+
+  while (shift < 64 && (character = fgetc(file)) != EOF)
+  {
+    *value |= (unsigned long long)(character & 0x7F) << shift;
+    if (!(character & 0x80))
+      return TRUE;
+    shift += 7;
+  }
+
+  return FALSE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Maps a signed value to an unsigned one so that small negative values
+/// also result in short varints.
+///
+/// @param value Value to be mapped.
+/// @return unsigned long long The zigzag encoded value
+//
+unsigned long long zigzagEncode(long long value)
+{
+  return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Reverts zigzagEncode().
+///
+/// @param value Value to be mapped.
+/// @return long long The signed value
+//
+long long zigzagDecode(unsigned long long value)
+{
+  return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Opens the binary trace file and starts the background writer thread.
+/// The header of the file holds all rules, so the trace can be decoded
+/// without the machine file.
+///
+/// @param filename Path of the trace file which should be written.
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - trace successfully opened
+///         int (2) - out of memory
+///         int (6) - writing the trace failed
+//
+int openTrace(char* filename, Turing* machine)
+{
+  int buffer_counter = 0;
+  int rules_counter = 0;
+  int header_length = 0;
+  unsigned char header[32];
+
+  Trace* trace = calloc(1, sizeof(Trace));
+  if (!trace)
+  {
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  for (; buffer_counter < TRACE_BUFFER_COUNT; buffer_counter++)
+    trace->buffers_[buffer_counter] = malloc(TRACE_BUFFER_RECORDS *
+                                             TRACE_MAX_RECORD_BYTES);
+  for (buffer_counter = 0; buffer_counter < TRACE_BUFFER_COUNT;
+       buffer_counter++)
+  {
+    if (!trace->buffers_[buffer_counter])
+    {
+      freeTrace(trace);
+      printf(OUT_OF_MEMORY);
+      return ERROR_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  trace->file_ = fopen(filename, "wb");
+  if (!trace->file_)
+  {
+    freeTrace(trace);
+    printf(WRITING_THE_TRACE_FAILED);
+    return ERROR_CODE_WRITING_THE_TRACE_FAILED;
+  }
+  trace->cursor_ = trace->buffers_[0];
+
+  fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), trace->file_);
+  //the unfused copy is included, steps executed from it refer to it
+  header_length = packVarint(header, machine->rules_count_ +
+                                     machine->unfused_rules_count_);
+  fwrite(header, 1, header_length, trace->file_);
+  for (; rules_counter < machine->rules_count_ +
+                         machine->unfused_rules_count_; rules_counter++)
+  {
+    Rules* rule = &machine->rules_[rules_counter];
+    header_length = packVarint(header, zigzagEncode(rule->current_state_));
+    header[header_length++] = rule->readed_symbol_;
+    header[header_length++] = rule->symbol_to_write_;
+    header_length += packVarint(header + header_length,
+                                zigzagEncode(rule->next_state_));
+    header[header_length++] = rule->head_movement_;
+    header_length += packVarint(header + header_length,
+                                zigzagEncode(rule->move_distance_));
+    fwrite(header, 1, header_length, trace->file_);
+  }
+
+  pthread_mutex_init(&trace->lock_, NULL);
+  pthread_cond_init(&trace->filled_, NULL);
+  pthread_cond_init(&trace->drained_, NULL);
+  if (pthread_create(&trace->writer_, NULL, writeTraceBuffers, trace) != 0)
+  {
+    fclose(trace->file_);
+    freeTrace(trace);
+    printf(WRITING_THE_TRACE_FAILED);
+    return ERROR_CODE_WRITING_THE_TRACE_FAILED;
+  }
+
+  machine->trace_ = trace;
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Appends one executed rule to the trace. The record is delta and varint
+/// packed right into the block of the executing thread, usually as three
+/// bytes; writing the block to the file is left to the background writer.
+///
+/// @param trace The opened trace
+/// @param step Number of the executed step
+/// @param rule Index of the executed rule
+/// @param position Head position the rule was executed at
+//
+void recordTraceStep(Trace* trace, long long step, int rule, int position)
+{
+  unsigned char* cursor = trace->cursor_;
+  unsigned long long step_delta = step - trace->previous_step_;
+  unsigned long long position_delta =
+    zigzagEncode(position - trace->previous_position_);
+
+  //a single step with a small rule index moving the head by a few cells
+  if ((step_delta | position_delta | (unsigned int)rule) < 0x80)
+  {
+    cursor[0] = (unsigned char)step_delta;
+    cursor[1] = (unsigned char)rule;
+    cursor[2] = (unsigned char)position_delta;
+    trace->cursor_ = cursor + 3;
+  }
+  else
+    packTraceRecord(trace, step_delta, rule, position_delta);
+  trace->previous_step_ = step;
+  trace->previous_position_ = position;
+
+  trace->active_count_++;
+  if (trace->active_count_ == TRACE_BUFFER_RECORDS)
+    flushTraceBuffer(trace);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Packs a trace record that does not fit into three bytes. Kept apart so
+/// the common case in recordTraceStep stays short and free of loops.
+///
+/// @param trace The opened trace
+/// @param step_delta Steps since the previous record
+/// @param rule Index of the executed rule
+/// @param position_delta Zigzag encoded head movement since the previous record
+//
+void packTraceRecord(Trace* trace, unsigned long long step_delta, int rule,
+                     unsigned long long position_delta)
+{
+  unsigned char* cursor = trace->cursor_;
+
+  cursor += packVarint(cursor, step_delta);
+  cursor += packVarint(cursor, rule);
+  cursor += packVarint(cursor, position_delta);
+  trace->cursor_ = cursor;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Hands the active block over to the writer thread and continues with the
+/// next free one. Only blocks if the writer is behind by all buffers. Each
+/// block starts its deltas from zero, so it can be decoded on its own.
+///
+/// @param trace The opened trace
+//
+void flushTraceBuffer(Trace* trace)
+{
+  if (trace->active_count_ == 0)
+    return;
+
+  pthread_mutex_lock(&trace->lock_);
+  while (trace->queue_length_ >= TRACE_BUFFER_COUNT - 1)
+    pthread_cond_wait(&trace->drained_, &trace->lock_);
+
+  trace->buffer_counts_[trace->active_buffer_] = trace->active_count_;
+  trace->buffer_lengths_[trace->active_buffer_] =
+    trace->cursor_ - trace->buffers_[trace->active_buffer_];
+  trace->queue_length_++;
+  trace->active_buffer_ = (trace->active_buffer_ + 1) % TRACE_BUFFER_COUNT;
+  trace->active_count_ = 0;
+  trace->cursor_ = trace->buffers_[trace->active_buffer_];
+  trace->previous_step_ = 0;
+  trace->previous_position_ = 0;
+  pthread_cond_signal(&trace->filled_);
+  pthread_mutex_unlock(&trace->lock_);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Background writer thread. Every filled block is appended to the trace
+/// file behind its record count and byte count.
+///
+/// @param argument The opened trace
+/// @return void* Always NULL
+//
+void* writeTraceBuffers(void* argument)
+{
+  Trace* trace = argument;
+
+  pthread_mutex_lock(&trace->lock_);
+  while (TRUE)
+  {
+    while (trace->queue_length_ == 0 && !trace->closing_)
+      pthread_cond_wait(&trace->filled_, &trace->lock_);
+    if (trace->queue_length_ == 0)
+      break;
+
+    int buffer = trace->queue_head_;
+    int record_count = trace->buffer_counts_[buffer];
+    int packed_length = trace->buffer_lengths_[buffer];
+    pthread_mutex_unlock(&trace->lock_);
+
+    int block_header_length = 0;
+    unsigned char block_header[20];
+
+    block_header_length = packVarint(block_header, record_count);
+    block_header_length += packVarint(block_header + block_header_length,
+                                      packed_length);
+    if (fwrite(block_header, 1, block_header_length, trace->file_) !=
+          (size_t)block_header_length ||
+        fwrite(trace->buffers_[buffer], 1, packed_length, trace->file_) !=
+          (size_t)packed_length)
+      trace->write_failed_ = TRUE;
+
+    pthread_mutex_lock(&trace->lock_);
+    trace->queue_head_ = (trace->queue_head_ + 1) % TRACE_BUFFER_COUNT;
+    trace->queue_length_--;
+    pthread_cond_signal(&trace->drained_);
+  }
+  pthread_mutex_unlock(&trace->lock_);
+
+  return NULL;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Flushes the remaining records, stops the writer thread and closes the
+/// trace file.
+///
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+/// @return int (0) - trace successfully written
+///         int (6) - writing the trace failed
+//
+int closeTrace(Turing* machine)
+{
+  int return_value = EVERYTHING_WORKED_FINE;
+  Trace* trace = machine->trace_;
+
+  flushTraceBuffer(trace);
+  pthread_mutex_lock(&trace->lock_);
+  trace->closing_ = TRUE;
+  pthread_cond_signal(&trace->filled_);
+  pthread_mutex_unlock(&trace->lock_);
+  pthread_join(trace->writer_, NULL);
+
+  if (fclose(trace->file_) != 0 || trace->write_failed_)
+  {
+    printf(WRITING_THE_TRACE_FAILED);
+    return_value = ERROR_CODE_WRITING_THE_TRACE_FAILED;
+  }
+
+  pthread_mutex_destroy(&trace->lock_);
+  pthread_cond_destroy(&trace->filled_);
+  pthread_cond_destroy(&trace->drained_);
+  freeTrace(trace);
+  machine->trace_ = NULL;
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Frees all buffers of the trace and the trace itself.
+///
+/// @param trace The trace to be freed
+//
+void freeTrace(Trace* trace)
+{
+  int buffer_counter = 0;
+
+  for (; buffer_counter < TRACE_BUFFER_COUNT; buffer_counter++)
+    free(trace->buffers_[buffer_counter]);
+  free(trace);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Decodes a binary trace and prints every executed rule in the same format
+/// as the step command.
+///
+/// @param filename Path of the trace file which should be decoded.
+/// @return int (0) - trace successfully decoded
+///         int (2) - out of memory
+///         int (3) - parsing the trace failed
+///         int (4) - reading the file failed
+//
+int decodeTrace(char* filename)
+{
+  int rules_counter = 0;
+  int return_value = EVERYTHING_WORKED_FINE;
+  char magic[sizeof(TRACE_MAGIC)] = {0};
+  unsigned long long rules_count = 0;
+  unsigned long long record_count = 0;
+  unsigned long long packed_length = 0;
+  unsigned long long value = 0;
+  Rules* rules = NULL;
+  unsigned char* packed = NULL;
+
+  FILE* trace_file = fopen(filename, "rb");
+  if (!trace_file)
+  {
+    printf(READING_THE_FILE_FAILED);
+    return ERROR_CODE_READING_THE_FILE_FAILED;
+  }
+
+  if (fread(magic, 1, strlen(TRACE_MAGIC), trace_file) != strlen(TRACE_MAGIC)
+      || strcmp(magic, TRACE_MAGIC) != 0
+      || !readVarint(trace_file, &rules_count) || rules_count > 0x7FFFFFFF)
+  {
+    fclose(trace_file);
+    printf(PARSING_THE_FILE_FAILED);
+    return ERROR_CODE_PARSING_THE_FILE_FAILED;
+  }
+
+  rules = calloc(rules_count + 1, sizeof(Rules));
+  if (!rules)
+  {
+    fclose(trace_file);
+    printf(OUT_OF_MEMORY);
+    return ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  for (; rules_counter < (int)rules_count &&
+         return_value == EVERYTHING_WORKED_FINE; rules_counter++)
+  {
+    Rules* rule = &rules[rules_counter];
+    if (!readVarint(trace_file, &value))
+      return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
+    rule->current_state_ = zigzagDecode(value);
+    rule->readed_symbol_ = fgetc(trace_file);
+    rule->symbol_to_write_ = fgetc(trace_file);
+    if (!readVarint(trace_file, &value))
+      return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
+    rule->next_state_ = zigzagDecode(value);
+    rule->head_movement_ = fgetc(trace_file);
+    if (!readVarint(trace_file, &value))
+      return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
+    rule->move_distance_ = zigzagDecode(value);
+  }
+
+  while (return_value == EVERYTHING_WORKED_FINE &&
+         readVarint(trace_file, &record_count))
+  {
+    unsigned char* cursor = NULL;
+    unsigned char* end = NULL;
+    unsigned long long step_delta = 0;
+    unsigned long long rule = 0;
+    unsigned long long position_delta = 0;
+
+    if (!readVarint(trace_file, &packed_length) ||
+        packed_length > (unsigned long long)TRACE_BUFFER_RECORDS *
+                        TRACE_MAX_RECORD_BYTES)
+    {
+      return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
+      break;
+    }
+
+    if (!packed)
+      packed = malloc(TRACE_BUFFER_RECORDS * TRACE_MAX_RECORD_BYTES);
+    if (!packed)
+    {
+      return_value = ERROR_CODE_OUT_OF_MEMORY;
+      break;
+    }
+    if (fread(packed, 1, packed_length, trace_file) != packed_length)
+    {
+      return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
+      break;
+    }
+
+    cursor = packed;
+    end = packed + packed_length;
+    for (; record_count > 0; record_count--)
+    {
+      if (!unpackVarint(&cursor, end, &step_delta) ||
+          !unpackVarint(&cursor, end, &rule) ||
+          !unpackVarint(&cursor, end, &position_delta) ||
+          rule >= rules_count)
+      {
+        return_value = ERROR_CODE_PARSING_THE_FILE_FAILED;
+        break;
+      }
+      printRule(&rules[rule]);
+    }
+  }
+
+  if (return_value == ERROR_CODE_OUT_OF_MEMORY)
+    printf(OUT_OF_MEMORY);
+  else if (return_value == ERROR_CODE_PARSING_THE_FILE_FAILED)
+    printf(PARSING_THE_FILE_FAILED);
+
+  fclose(trace_file);
+  free(packed);
+  free(rules);
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Enumerates all machines with n states and m symbols in tree normal form
+/// and prints one line per machine: its class (halting, non-halting or
+/// undecided), the number of executed steps and the machine in the common
+/// compact notation (state A is 1, symbol 0 is the blank '_', "---" is an
+/// undefined transition, i.e. the machine stops there).
+/// The tree is expanded up to ENUMERATION_FRONTIER_SIZE subtrees which are
+/// then explored by one worker thread per core. With a checkpoint every
+/// finished subtree is recorded and skipped when the enumeration is resumed.
+///
+/// @param options The parsed command line options
+/// @return int (0) - no errors
+///         int (2) - out of memory
+///         int (4) - reading the checkpoint failed
+///         int (8) - checkpoint does not match or cannot be written
+//
+int enumerateMachines(Options* options)
+{
+  int worker_counter = 0;
+  int worker_count = sysconf(_SC_NPROCESSORS_ONLN);
+  int return_value = EVERYTHING_WORKED_FINE;
+  long long tape_size = options->max_steps_ * 2 + 3;
+  struct stat checkpoint_status;
+  Boolean resume = FALSE;
+  Enumeration enumeration;
+  EnumerationSummary summary;
+  EnumerationWorker* workers = NULL;
+
+  memset(&enumeration, 0, sizeof(Enumeration));
+  enumeration.state_count_ = options->enumerate_states_;
+  enumeration.symbol_count_ = options->enumerate_symbols_;
+  enumeration.max_steps_ = options->max_steps_;
+  clearEnumerationSummary(&enumeration.resumed_);
+  pthread_mutex_init(&enumeration.lock_, NULL);
+
+  //an empty checkpoint was interrupted before the first subtree
+  resume = options->checkpoint_file_ &&
+           stat(options->checkpoint_file_, &checkpoint_status) == 0 &&
+           checkpoint_status.st_size > 0;
+
+  if (worker_count < 1)
+    worker_count = 1;
+  workers = calloc(worker_count, sizeof(EnumerationWorker));
+  if (!workers)
+    return_value = ERROR_CODE_OUT_OF_MEMORY;
+
+  //the tapes are only touched as far as the machines get
+  for (; workers && worker_counter < worker_count; worker_counter++)
+  {
+    EnumerationWorker* worker = &workers[worker_counter];
+    worker->enumeration_ = &enumeration;
+    clearEnumerationSummary(&worker->subtree_);
+    clearEnumerationSummary(&worker->total_);
+    worker->tape_ = calloc(tape_size, sizeof(unsigned char));
+    worker->snapshot_ = malloc(tape_size);
+    worker->output_ = malloc(ENUMERATION_OUTPUT_SIZE);
+    if (!worker->tape_ || !worker->snapshot_ || !worker->output_)
+      return_value = ERROR_CODE_OUT_OF_MEMORY;
+  }
+
+  //the upper levels are run again on resume, they are only counted then
+  if (return_value == EVERYTHING_WORKED_FINE)
+  {
+    workers[0].quiet_ = resume;
+    return_value = expandEnumerationFrontier(&workers[0]);
+    workers[0].quiet_ = FALSE;
+    flushEnumerationOutput(&workers[0], -1);
+    addEnumerationSummary(&workers[0].total_, &workers[0].subtree_);
+    clearEnumerationSummary(&workers[0].subtree_);
+  }
+  if (return_value == EVERYTHING_WORKED_FINE)
+  {
+    enumeration.finished_items_ = calloc(enumeration.frontier_count_ + 1,
+                                         sizeof(unsigned char));
+    if (!enumeration.finished_items_)
+      return_value = ERROR_CODE_OUT_OF_MEMORY;
+  }
+  if (return_value == EVERYTHING_WORKED_FINE && options->checkpoint_file_)
+  {
+    fflush(stdout);
+    return_value = openEnumerationCheckpoint(options->checkpoint_file_,
+                                             &enumeration, resume);
+  }
+
+  if (return_value == EVERYTHING_WORKED_FINE)
+  {
+    //the main thread is the first worker, so no thread is a hard requirement
+    for (worker_counter = 1; worker_counter < worker_count; worker_counter++)
+      if (pthread_create(&workers[worker_counter].thread_, NULL,
+                         runEnumerationWorker, &workers[worker_counter]) != 0)
+        break;
+    worker_count = worker_counter;
+    runEnumerationWorker(&workers[0]);
+    for (worker_counter = 1; worker_counter < worker_count; worker_counter++)
+      pthread_join(workers[worker_counter].thread_, NULL);
+
+    //subtrees finished before a resume count from the checkpoint
+    summary = enumeration.resumed_;
+    for (worker_counter = 0; worker_counter < worker_count; worker_counter++)
+      addEnumerationSummary(&summary, &workers[worker_counter].total_);
+
+    printf("enumerated %lld machines: %lld halting, %lld non-halting, "
+           "%lld undecided\n", summary.results_[ENUMERATION_HALTING] +
+           summary.results_[ENUMERATION_NON_HALTING] +
+           summary.results_[ENUMERATION_UNDECIDED],
+           summary.results_[ENUMERATION_HALTING],
+           summary.results_[ENUMERATION_NON_HALTING],
+           summary.results_[ENUMERATION_UNDECIDED]);
+    if (summary.longest_run_ >= 0)
+      printf("longest halting run: %lld steps %s\n", summary.longest_run_,
+             summary.longest_machine_);
+
+    if (enumeration.checkpoint_failed_)
+    {
+      printf(CHECKPOINT_FAILED);
+      return_value = ERROR_CODE_CHECKPOINT_FAILED;
+    }
+  }
+  else if (return_value == ERROR_CODE_OUT_OF_MEMORY)
+    printf(OUT_OF_MEMORY);
+
+  if (enumeration.checkpoint_ && fclose(enumeration.checkpoint_) != 0 &&
+      return_value == EVERYTHING_WORKED_FINE)
+  {
+    printf(CHECKPOINT_FAILED);
+    return_value = ERROR_CODE_CHECKPOINT_FAILED;
+  }
+  for (worker_counter = 0; workers && worker_counter < worker_count;
+       worker_counter++)
+  {
+    free(workers[worker_counter].tape_);
+    free(workers[worker_counter].snapshot_);
+    free(workers[worker_counter].output_);
+    free(workers[worker_counter].children_);
+  }
+  free(workers);
+  free(enumeration.frontier_);
+  free(enumeration.finished_items_);
+  pthread_mutex_destroy(&enumeration.lock_);
+
+  return return_value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Explores the enumeration tree level by level, starting with the machine
+/// without any transition, until there are enough unexplored subtrees to
+/// keep all workers busy. The frontier does not depend on the number of
+/// cores, so a checkpoint can be resumed on a different computer.
+///
+/// @param worker The worker used to run the machines of the upper levels
+/// @return int (0) - no errors
+///         int (2) - out of memory
+//
+int expandEnumerationFrontier(EnumerationWorker* worker)
+{
+  int item = 0;
+  int transition_counter = 0;
+  Enumeration* enumeration = worker->enumeration_;
+
+  enumeration->frontier_ = calloc(1, sizeof(EnumerationMachine));
+  if (!enumeration->frontier_)
+    return ERROR_CODE_OUT_OF_MEMORY;
+  for (; transition_counter < ENUMERATION_MAX_TRANSITIONS; transition_counter++)
+    enumeration->frontier_[0].transitions_[transition_counter].next_ = -1;
+  enumeration->frontier_[0].states_used_ = 1;
+  enumeration->frontier_[0].symbols_used_ = 1;
+  enumeration->frontier_count_ = 1;
+
+  worker->collect_children_ = TRUE;
+  while (enumeration->frontier_count_ > 0 &&
+         enumeration->frontier_count_ < ENUMERATION_FRONTIER_SIZE &&
+         !worker->out_of_memory_)
+  {
+    worker->children_ = NULL;
+    worker->children_count_ = 0;
+    worker->children_limit_ = 0;
+    for (item = 0; item < enumeration->frontier_count_; item++)
+      exploreMachine(worker, &enumeration->frontier_[item]);
+
+    free(enumeration->frontier_);
+    enumeration->frontier_ = worker->children_;
+    enumeration->frontier_count_ = worker->children_count_;
+  }
+  worker->collect_children_ = FALSE;
+  worker->children_ = NULL;
+
+  return worker->out_of_memory_ ? ERROR_CODE_OUT_OF_MEMORY :
+                                  EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Opens the checkpoint of the enumeration. A new checkpoint starts with a
+/// header which describes the enumeration, followed by one line per
+/// finished subtree with its counts and its longest halting run. When
+/// resuming, the header has to match, all finished subtrees are marked and
+/// their summaries are added up. Incomplete lines are ignored.
+///
+/// @param filename Path of the checkpoint file
+/// @param enumeration The enumeration with its expanded frontier
+/// @param resume Whether the checkpoint already exists
+/// @return int (0) - no errors
+///         int (4) - reading the checkpoint failed
+///         int (8) - checkpoint does not match or cannot be written
+//
+int openEnumerationCheckpoint(char* filename, Enumeration* enumeration,
+                              Boolean resume)
+{
+  int item = 0;
+  int state_count = 0;
+  int symbol_count = 0;
+  int frontier_count = 0;
+  int machine_offset = 0;
+  long complete_length = 0;
+  long long max_steps = 0;
+  char* machine_text = NULL;
+  char line[ENUMERATION_MACHINE_TEXT + 128];
+  char magic[sizeof(ENUMERATION_CHECKPOINT_MAGIC)] = {0};
+  EnumerationSummary subtree;
+
+  if (resume)
+  {
+    FILE* checkpoint = fopen(filename, "r");
+    if (!checkpoint)
+    {
+      printf(READING_THE_FILE_FAILED);
+      return ERROR_CODE_READING_THE_FILE_FAILED;
+    }
+
+    if (!fgets(line, sizeof(line), checkpoint) ||
+        sscanf(line, "%8s %i %i %lld %i", magic, &state_count, &symbol_count,
+               &max_steps, &frontier_count) != 5 ||
+        strcmp(magic, ENUMERATION_CHECKPOINT_MAGIC) != 0 ||
+        state_count != enumeration->state_count_ ||
+        symbol_count != enumeration->symbol_count_ ||
+        max_steps != enumeration->max_steps_ ||
+        frontier_count != enumeration->frontier_count_)
+    {
+      fclose(checkpoint);
+      printf(CHECKPOINT_FAILED);
+      return ERROR_CODE_CHECKPOINT_FAILED;
+    }
+
+    complete_length = ftell(checkpoint);
+    while (fgets(line, sizeof(line), checkpoint))
+    {
+      clearEnumerationSummary(&subtree);
+      machine_text = strchr(line, '\n');
+      if (machine_text)
+        complete_length = ftell(checkpoint);
+      if (!machine_text ||
+          sscanf(line, "%i %lld %lld %lld %lld %n", &item,
+                 &subtree.results_[ENUMERATION_HALTING],
+                 &subtree.results_[ENUMERATION_NON_HALTING],
+                 &subtree.results_[ENUMERATION_UNDECIDED],
+                 &subtree.longest_run_, &machine_offset) != 5 ||
+          item < 0 || item >= frontier_count ||
+          enumeration->finished_items_[item])
+        continue;
+
+      *machine_text = '\0';
+      machine_text = line + machine_offset;
+      if (subtree.longest_run_ >= 0 &&
+          strlen(machine_text) < ENUMERATION_MACHINE_TEXT)
+        strcpy(subtree.longest_machine_, machine_text);
+      else
+        subtree.longest_run_ = -1;
+
+      enumeration->finished_items_[item] = TRUE;
+      addEnumerationSummary(&enumeration->resumed_, &subtree);
+    }
+    fclose(checkpoint);
+
+    //an interrupted run may have left half a line, new lines appended to it
+    //would be misread on the next resume
+    if (truncate(filename, complete_length) == 0)
+      enumeration->checkpoint_ = fopen(filename, "a");
+  }
+  else
+  {
+    enumeration->checkpoint_ = fopen(filename, "w");
+    if (enumeration->checkpoint_)
+      fprintf(enumeration->checkpoint_, "%s %i %i %lld %i\n",
+              ENUMERATION_CHECKPOINT_MAGIC, enumeration->state_count_,
+              enumeration->symbol_count_, enumeration->max_steps_,
+              enumeration->frontier_count_);
+  }
+
+  if (!enumeration->checkpoint_ || fflush(enumeration->checkpoint_) != 0)
+  {
+    printf(CHECKPOINT_FAILED);
+    return ERROR_CODE_CHECKPOINT_FAILED;
+  }
+
+  return EVERYTHING_WORKED_FINE;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Worker thread of the enumeration. Takes the next unfinished subtree of
+/// the frontier, explores it completely and reports it as finished.
+///
+/// @param argument The worker
+/// @return void* Always NULL
+//
+void* runEnumerationWorker(void* argument)
+{
+  int item = 0;
+  EnumerationWorker* worker = argument;
+  Enumeration* enumeration = worker->enumeration_;
+  EnumerationMachine machine;
+
+  while (TRUE)
+  {
+    pthread_mutex_lock(&enumeration->lock_);
+    while (enumeration->next_item_ < enumeration->frontier_count_ &&
+           enumeration->finished_items_[enumeration->next_item_])
+      enumeration->next_item_++;
+    item = enumeration->next_item_;
+    if (item < enumeration->frontier_count_)
+      enumeration->next_item_++;
+    pthread_mutex_unlock(&enumeration->lock_);
+
+    if (item >= enumeration->frontier_count_)
+      break;
+
+    machine = enumeration->frontier_[item];
+    exploreMachine(worker, &machine);
+    flushEnumerationOutput(worker, item);
+  }
+
+  return NULL;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Runs and reports one machine and explores all machines which define the
+/// transition it stopped at. Only the next unused state and symbol may be
+/// introduced (tree normal form), so machines which only differ by the
+/// names of their states or symbols are generated once. The first
+/// transition is always 1RB, its alternatives are mirror images or only
+/// delay the start. Machines without an undefined transition can never
+/// halt and are not generated.
+///
+/// @param worker The worker running the machine
+/// @param machine The machine, restored when the function returns
+//
+void exploreMachine(EnumerationWorker* worker, EnumerationMachine* machine)
+{
+  int halt_transition = 0;
+  int next = 0;
+  int write = 0;
+  int move = 0;
+  int states_used = machine->states_used_;
+  int symbols_used = machine->symbols_used_;
+  int next_limit = 0;
+  int write_limit = 0;
+  long long steps = 0;
+  Enumeration* enumeration = worker->enumeration_;
+  EnumerationTransition* transition = NULL;
+  EnumerationResult result = runEnumeratedMachine(worker, machine, &steps,
+                                                  &halt_transition);
+
+  reportEnumeratedMachine(worker, machine, result, steps);
+  if (result != ENUMERATION_HALTING || machine->defined_count_ + 1 >=
+        enumeration->state_count_ * enumeration->symbol_count_)
+    return;
+
+  transition = &machine->transitions_[halt_transition];
+  next_limit = states_used < enumeration->state_count_ ? states_used + 1 :
+                                                         states_used;
+  write_limit = symbols_used < enumeration->symbol_count_ ? symbols_used + 1 :
+                                                            symbols_used;
+
+  machine->defined_count_++;
+  for (next = 0; next < next_limit; next++)
+  {
+    for (write = 0; write < write_limit; write++)
+    {
+      for (move = -1; move <= 1; move += 2)
+      {
+        if (machine->defined_count_ == 1 &&
+            (move < 0 || write != write_limit - 1 || next != next_limit - 1))
+          continue;
+
+        transition->write_ = write;
+        transition->move_ = move;
+        transition->next_ = next;
+        machine->states_used_ = next < states_used ? states_used : next + 1;
+        machine->symbols_used_ = write < symbols_used ? symbols_used :
+                                                        write + 1;
+        if (worker->collect_children_)
+          appendEnumerationChild(worker, machine);
+        else
+          exploreMachine(worker, machine);
+      }
+    }
+  }
+  machine->defined_count_--;
+  machine->states_used_ = states_used;
+  machine->symbols_used_ = symbols_used;
+  transition->next_ = -1;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Appends a copy of the machine to the next level of the frontier.
+///
+/// @param worker The worker expanding the frontier
+/// @param machine The machine to be copied
+//
+void appendEnumerationChild(EnumerationWorker* worker,
+                            EnumerationMachine* machine)
+{
+  if (worker->children_count_ == worker->children_limit_)
+  {
+    int children_limit = worker->children_limit_ * 2 + 64;
+    EnumerationMachine* children = realloc(worker->children_, children_limit *
+                                           sizeof(EnumerationMachine));
+    if (!children)
+    {
+      worker->out_of_memory_ = TRUE;
+      return;
+    }
+    worker->children_ = children;
+    worker->children_limit_ = children_limit;
+  }
+
+  worker->children_[worker->children_count_++] = *machine;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Runs a machine on the blank tape of the worker until it reaches an
+/// undefined transition, until the step limit or until it is proven not to
+/// halt. The tape is large enough for the step limit, so the hot loop
+/// needs no bounds check. Afterwards the visited cells are blanked again.
+/// Two kinds of snapshots are taken at powers of two steps (Brent):
+/// - the visited cells; reaching the same configuration again is a cycle.
+/// - the visited cells when the head reaches a new cell; reaching a new
+///   cell in the same direction and state with the same cells behind the
+///   head (as far as it went back in between) repeats forever, shifted.
+///
+/// @param worker The worker running the machine
+/// @param machine The machine to be run
+/// @param steps Number of executed steps
+/// @param halt_transition Index of the undefined transition the machine
+///        stopped at
+/// @return EnumerationResult Class of the machine
+//
+EnumerationResult runEnumeratedMachine(EnumerationWorker* worker,
+                                       EnumerationMachine* machine,
+                                       long long* steps, int* halt_transition)
+{
+  int state = 0;
+  int snapshot_state = -1;
+  int symbol_count = worker->enumeration_->symbol_count_;
+  long long max_steps = worker->enumeration_->max_steps_;
+  long long step_count = 0;
+  long long snapshot_step = 1;
+  long long head = max_steps + 1;
+  long long leftmost = head;
+  long long rightmost = head;
+  long long snapshot_head = 0;
+  long long snapshot_leftmost = 0;
+  long long snapshot_rightmost = 0;
+  int anchor_state = -1;
+  int anchor_direction = 0;
+  long long anchor_step = 1;
+  long long anchor_head = 0;
+  long long anchor_leftmost = 0;
+  long long anchor_rightmost = 0;
+  long long anchor_low = head;
+  long long anchor_high = head;
+  long long distance = 0;
+  long long position = 0;
+  unsigned char* tape = worker->tape_;
+  unsigned char* anchor = worker->snapshot_ + max_steps + 1;
+  EnumerationTransition* transition = NULL;
+  EnumerationResult result = ENUMERATION_UNDECIDED;
+
+  while (TRUE)
+  {
+    transition = &machine->transitions_[state * symbol_count + tape[head]];
+    if (transition->next_ < 0)
+    {
+      *halt_transition = state * symbol_count + tape[head];
+      result = ENUMERATION_HALTING;
+      break;
+    }
+    if (step_count == max_steps)
+      break;
+
+    tape[head] = transition->write_;
+    head += transition->move_;
+    state = transition->next_;
+    step_count++;
+    if (head < anchor_low || head > anchor_high)
+    {
+      if (head < anchor_low)
+        anchor_low = head;
+      else
+        anchor_high = head;
+
+      if (head < leftmost || head > rightmost)
+      {
+        int direction = head < leftmost ? -1 : 1;
+        if (direction < 0)
+          leftmost = head;
+        else
+          rightmost = head;
+
+        if (direction == anchor_direction && state == anchor_state &&
+            (direction > 0 ? anchor_low >= anchor_leftmost :
+                             anchor_high <= anchor_rightmost))
+        {
+          //compare the cells the head went back over, starting at the edge
+          distance = head - anchor_head;
+          if (direction > 0)
+            for (position = anchor_head; position >= anchor_low &&
+                 anchor[position - anchor_leftmost] == tape[position +
+                                                            distance];
+                 position--);
+          else
+            for (position = anchor_head; position <= anchor_high &&
+                 anchor[position - anchor_leftmost] == tape[position +
+                                                            distance];
+                 position++);
+          if (position < anchor_low || position > anchor_high)
+          {
+            result = ENUMERATION_NON_HALTING;
+            break;
+          }
+        }
+        if (step_count >= anchor_step)
+        {
+          anchor_state = state;
+          anchor_direction = direction;
+          anchor_head = head;
+          anchor_leftmost = leftmost;
+          anchor_rightmost = rightmost;
+          anchor_low = head;
+          anchor_high = head;
+          memcpy(anchor, tape + leftmost, rightmost - leftmost + 1);
+          anchor_step *= 2;
+        }
+      }
+    }
+
+    if (state == snapshot_state && head == snapshot_head &&
+        leftmost == snapshot_leftmost && rightmost == snapshot_rightmost &&
+        memcmp(tape + leftmost, worker->snapshot_,
+               rightmost - leftmost + 1) == 0)
+    {
+      result = ENUMERATION_NON_HALTING;
+      break;
+    }
+    if (step_count == snapshot_step)
+    {
+      snapshot_state = state;
+      snapshot_head = head;
+      snapshot_leftmost = leftmost;
+      snapshot_rightmost = rightmost;
+      memcpy(worker->snapshot_, tape + leftmost, rightmost - leftmost + 1);
+      snapshot_step *= 2;
+    }
+  }
 
-  for (; rules_counter < machine->rules_count_ && !FOUND_RULE; rules_counter++)
+  if (result == ENUMERATION_UNDECIDED &&
+      checkNonHalting(worker, machine, state, head, leftmost, rightmost))
+    result = ENUMERATION_NON_HALTING;
+
+  memset(tape + leftmost, 0, rightmost - leftmost + 1);
+  *steps = step_count;
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Cheap proofs for a machine which reached the step limit: no undefined
+/// transition can be reached from the current state, or the head is on the
+/// blank part of the tape and the transitions on blank keep moving it
+/// further into the blank part forever.
+///
+/// @param worker The worker running the machine
+/// @param machine The machine
+/// @param state Current state of the machine
+/// @param head Current head position on the tape of the worker
+/// @param leftmost Leftmost visited cell
+/// @param rightmost Rightmost visited cell
+/// @return Boolean (TRUE) - the machine never halts
+///         Boolean (FALSE) - undecided
+//
+Boolean checkNonHalting(EnumerationWorker* worker, EnumerationMachine* machine,
+                        int state, long long head, long long leftmost,
+                        long long rightmost)
+{
+  int direction = 0;
+  int queue_counter = 0;
+  int queue_length = 1;
+  int symbol_counter = 0;
+  int symbol_count = worker->enumeration_->symbol_count_;
+  int queue[ENUMERATION_MAX_STATES];
+  unsigned char reached[ENUMERATION_MAX_STATES] = {0};
+  unsigned char* tape = worker->tape_;
+  EnumerationTransition* transition = NULL;
+
+  queue[0] = state;
+  reached[state] = TRUE;
+  for (; queue_counter < queue_length; queue_counter++)
   {
-    current_state = machine->rules_[rules_counter].current_state_;
-    if (current_state == state_at_header_position)
+    for (symbol_counter = 0; symbol_counter < machine->symbols_used_;
+         symbol_counter++)
     {
-      symbol = machine->band_[head_position];
-      symbol_to_read = machine->rules_[rules_counter].readed_symbol_;
-      if (symbol == symbol_to_read)
+      transition = &machine->transitions_[queue[queue_counter] *
+                                          symbol_count + symbol_counter];
+      if (transition->next_ < 0)
+        break;
+      if (!reached[transition->next_])
       {
-        FOUND_RULE = TRUE;
-        machine->current_rule_ = rules_counter;
-        next_state = machine->rules_[rules_counter].next_state_;
-        head_movement = machine->rules_[rules_counter].head_movement_;
-        symbol_to_write = machine->rules_[rules_counter].symbol_to_write_;
-
-        machine->current_state_ = next_state;
-        machine->band_[head_position] = symbol_to_write;
-        if (head_movement == 'R')
-        {
-          machine->head_position_++;
-        }
-        else if (head_movement == 'L')
-        {
-          machine->head_position_--;
-        }
+        reached[transition->next_] = TRUE;
+        queue[queue_length++] = transition->next_;
       }
     }
+    if (symbol_counter < machine->symbols_used_)
+      break;
   }
+  if (queue_counter == queue_length)
+    return TRUE;
 
-  if (FOUND_RULE)
-    printf("%i %c -> %c %i %c \n", current_state, symbol_to_read,
-           symbol_to_write, next_state, head_movement);
-  else
-    machine->turing_over_ = TRUE;
+  for (direction = -1; direction <= 1; direction += 2)
+  {
+    int blank_state = state;
+    long long position = head;
+
+    while (position >= leftmost && position <= rightmost && !tape[position])
+      position += direction;
+    if (position >= leftmost && position <= rightmost)
+      continue;
+
+    memset(reached, 0, sizeof(reached));
+    while (TRUE)
+    {
+      transition = &machine->transitions_[blank_state * symbol_count];
+      if (transition->next_ < 0 || transition->move_ != direction)
+        break;
+      if (reached[blank_state])
+        return TRUE;
+      reached[blank_state] = TRUE;
+      blank_state = transition->next_;
+    }
+  }
+
+  return FALSE;
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to execute as many rules as possible till the next break point or
-/// the end of the program (which means no rule is matching anymore).
+/// Counts a machine in the summary of the current subtree and appends its
+/// result line to the output buffer of the worker.
 ///
-/// @param machine Struct with all components to descripe the turing machine
-///        (state, rules, etc.)
+/// @param worker The worker running the machine
+/// @param machine The machine
+/// @param result Class of the machine
+/// @param steps Number of executed steps
 //
-void executeRules(Turing* machine) //TODO Write Breakpoint past noch nit
+void reportEnumeratedMachine(EnumerationWorker* worker,
+                             EnumerationMachine* machine,
+                             EnumerationResult result, long long steps)
 {
-  int next_state = 0;
-  int current_state = 0;
-  int rules_counter = 0;
-  int state_at_header_position = 0;
-  int head_position = machine->head_position_;
-
-  char symbol = 0;
-  char head_movement = 0;
-  char symbol_to_read = 0;
-  char symbol_to_write = 0;
+  char* result_names[] = {"halting", "non-halting", "undecided"};
+  char text[ENUMERATION_MACHINE_TEXT];
 
-  for (; rules_counter < machine->rules_count_; rules_counter++)
+  formatEnumeratedMachine(worker->enumeration_, machine, text);
+  worker->subtree_.results_[result]++;
+  if (result == ENUMERATION_HALTING && steps > worker->subtree_.longest_run_)
   {
-    if (checkIntBreakpoints(machine, "pos", head_position))
-      break;
+    worker->subtree_.longest_run_ = steps;
+    strcpy(worker->subtree_.longest_machine_, text);
+  }
 
-    state_at_header_position = machine->current_state_;
-    if (checkIntBreakpoints(machine, "state", state_at_header_position))
-      break;
+  if (worker->quiet_)
+    return;
 
-    current_state = machine->rules_[rules_counter].current_state_;
-    symbol = machine->band_[head_position];
-    if (checkCharBreakpoints(machine, "read", symbol))
-      break;
+  if (worker->output_length_ + ENUMERATION_MACHINE_TEXT + 40 >
+        ENUMERATION_OUTPUT_SIZE)
+    flushEnumerationOutput(worker, -1);
+  worker->output_length_ += sprintf(worker->output_ + worker->output_length_,
+                                    "%s %lld %s\n", result_names[result],
+                                    steps, text);
+}
 
-	symbol_to_write = machine->rules_[rules_counter].symbol_to_write_;
-	if (checkCharBreakpoints(machine, "write", symbol_to_write))
-	  break;
+//-----------------------------------------------------------------------------
+///
+/// Formats a machine in the compact notation, e.g. 1RB1LB_1LA---.
+///
+/// @param enumeration The enumeration
+/// @param machine The machine to be formatted
+/// @param text Buffer of ENUMERATION_MACHINE_TEXT characters
+//
+void formatEnumeratedMachine(Enumeration* enumeration,
+                             EnumerationMachine* machine, char* text)
+{
+  int state_counter = 0;
+  int symbol_counter = 0;
 
-    if (current_state == state_at_header_position)
+  for (; state_counter < enumeration->state_count_; state_counter++)
+  {
+    if (state_counter > 0)
+      *text++ = '_';
+    for (symbol_counter = 0; symbol_counter < enumeration->symbol_count_;
+         symbol_counter++)
     {
-      symbol_to_read = machine->rules_[rules_counter].readed_symbol_;
-      if (symbol == symbol_to_read)
+      EnumerationTransition* transition = &machine->transitions_[
+        state_counter * enumeration->symbol_count_ + symbol_counter];
+      if (transition->next_ < 0)
       {
-        machine->current_rule_ = rules_counter;
-        next_state = machine->rules_[rules_counter].next_state_;
-        head_movement = machine->rules_[rules_counter].head_movement_;
-        machine->current_state_ = next_state;
-        machine->band_[head_position] = symbol_to_write;
-        if (head_movement == 'R')
-        {
-          machine->head_position_++;
-        }
-        else if (head_movement == 'L')
-        {
-          machine->head_position_--;
-        }
-        head_position = machine->head_position_;
-        rules_counter = -1;
+        memcpy(text, "---", 3);
+      }
+      else
+      {
+        text[0] = '0' + transition->write_;
+        text[1] = transition->move_ < 0 ? 'L' : 'R';
+        text[2] = 'A' + transition->next_;
       }
+      text += 3;
     }
   }
+  *text = '\0';
+}
 
-  if (rules_counter == machine->rules_count_)
-    machine->turing_over_ = TRUE;
+//-----------------------------------------------------------------------------
+///
+/// Writes the output buffer of the worker to stdout. When a subtree is
+/// finished, its results are flushed before it is recorded in the
+/// checkpoint, so a resumed enumeration never misses a result. The
+/// checkpoint line holds the summary of the subtree, which is then added
+/// to the total of the worker.
+///
+/// @param worker The worker
+/// @param finished_item Index of the finished subtree, -1 if none
+//
+void flushEnumerationOutput(EnumerationWorker* worker, int finished_item)
+{
+  Enumeration* enumeration = worker->enumeration_;
+
+  pthread_mutex_lock(&enumeration->lock_);
+  fwrite(worker->output_, 1, worker->output_length_, stdout);
+  worker->output_length_ = 0;
+  if (finished_item >= 0 && enumeration->checkpoint_)
+  {
+    EnumerationSummary* subtree = &worker->subtree_;
+    fflush(stdout);
+    if (fprintf(enumeration->checkpoint_, "%i %lld %lld %lld %lld %s\n",
+                finished_item, subtree->results_[ENUMERATION_HALTING],
+                subtree->results_[ENUMERATION_NON_HALTING],
+                subtree->results_[ENUMERATION_UNDECIDED],
+                subtree->longest_run_, subtree->longest_run_ >= 0 ?
+                                       subtree->longest_machine_ : "-") < 0 ||
+        fflush(enumeration->checkpoint_) != 0)
+      enumeration->checkpoint_failed_ = TRUE;
+  }
+  pthread_mutex_unlock(&enumeration->lock_);
+
+  if (finished_item >= 0)
+  {
+    addEnumerationSummary(&worker->total_, &worker->subtree_);
+    clearEnumerationSummary(&worker->subtree_);
+  }
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to check int Breakpoints.
+/// Resets a summary of enumerated machines.
+///
+/// @param summary The summary to be reset
+//
+void clearEnumerationSummary(EnumerationSummary* summary)
+{
+  memset(summary, 0, sizeof(EnumerationSummary));
+  summary->longest_run_ = -1;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Adds the counts of a summary to another one and keeps the longest
+/// halting run of both.
+///
+/// @param total The summary which is added to
+/// @param part The summary to be added
+//
+void addEnumerationSummary(EnumerationSummary* total,
+                           EnumerationSummary* part)
+{
+  total->results_[ENUMERATION_HALTING] += part->results_[ENUMERATION_HALTING];
+  total->results_[ENUMERATION_NON_HALTING] +=
+    part->results_[ENUMERATION_NON_HALTING];
+  total->results_[ENUMERATION_UNDECIDED] +=
+    part->results_[ENUMERATION_UNDECIDED];
+  if (part->longest_run_ > total->longest_run_)
+  {
+    total->longest_run_ = part->longest_run_;
+    strcpy(total->longest_machine_, part->longest_machine_);
+  }
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Mixes the bits of a value (finalizer of splitmix64), so similar values
+/// get unrelated hashes.
+///
+/// @param value The value to be mixed
+/// @return unsigned long long The mixed value
+//
+unsigned long long mixHash(unsigned long long value)
+{
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBULL;
+  value ^= value >> 31;
+  return value;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Hashes the rules of the machine. The hashes of the single rules are
+/// added, so the order of the rules in the file does not matter.
 ///
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
-/// @param type Type of the Breakpoint to be check.
-/// @param value Value to be check.
-/// @return Boolean (TRUE) - checkpoint exists
-///         Boolean (FALSE) - checkpoint doesn't exist
+/// @return unsigned long long Hash of the rules
 //
-Boolean checkIntBreakpoints(Turing* machine, char* type, int value)
+unsigned long long hashRules(Turing* machine)
 {
-  Boolean return_value = FALSE;
-
-  int breakpoints_counter = 0;
-  int breakpoints_length = machine->breakpoint_counter_;
+  int rules_counter = 0;
+  unsigned long long hash = mixHash(machine->rules_count_);
 
-  for (; breakpoints_counter < breakpoints_length; breakpoints_counter++)
+  for (; rules_counter < machine->rules_count_; rules_counter++)
   {
-    if (strcmp(machine->breakpoints_[breakpoints_counter].type_, type) == 0)
-      if (machine->breakpoints_[breakpoints_counter].value_ == value)
-      {
-        return_value = TRUE;
-        machine->breakpoints_[breakpoints_counter].value_ = -1;
-      }
+    Rules* rule = &machine->rules_[rules_counter];
+    unsigned long long rule_hash = mixHash(
+      (unsigned int)rule->current_state_ |
+      (unsigned long long)(unsigned char)rule->readed_symbol_ << 32 |
+      (unsigned long long)(unsigned char)rule->symbol_to_write_ << 40 |
+      (unsigned long long)(unsigned char)rule->head_movement_ << 48);
+    hash += mixHash(rule_hash ^ (unsigned int)rule->next_state_);
   }
 
-  return return_value;
+  return hash;
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to check char Breakpoints.
+/// Hashes the input of the machine: the non-blank part of the band with
+/// its position (FNV-1a), the head position and the start state.
 ///
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
-/// @param type Type of the Breakpoint to be check.
-/// @param symbol Symbol to be check.
-/// @return Boolean (TRUE) - checkpoint exists
-///         Boolean (FALSE) - checkpoint doesn't exist
+/// @return unsigned long long Hash of the input
 //
-Boolean checkCharBreakpoints(Turing* machine, char* type, char symbol)
+unsigned long long hashInput(Turing* machine)
 {
-  Boolean return_value = FALSE;
+  int first = 0;
+  int last = -1;
+  int band_position = 0;
+  unsigned long long hash = 0xCBF29CE484222325ULL;
 
-  int breakpoints_counter = 0;
-  int breakpoints_length = machine->breakpoint_counter_;
+  if (findBandExtent(machine, &first, &last))
+    for (band_position = first; band_position <= last; band_position++)
+    {
+      hash ^= (unsigned char)machine->band_[band_position];
+      hash *= 0x100000001B3ULL;
+    }
 
-  for (; breakpoints_counter < breakpoints_length; breakpoints_counter++)
-    if (strcmp(machine->breakpoints_[breakpoints_counter].type_, type) == 0)
-      if (machine->breakpoints_[breakpoints_counter].value_ == symbol)
-      {
-        return_value = TRUE;
-        machine->breakpoints_[breakpoints_counter].value_ = -1;
-      }
+  hash = mixHash(hash ^ (unsigned int)first);
+  hash = mixHash(hash ^ (unsigned int)machine->head_position_);
+  return mixHash(hash ^ (unsigned int)machine->start_state_);
+}
 
-  return return_value;
+//-----------------------------------------------------------------------------
+///
+/// Opens (or creates) the result cache and maps it into memory. The file
+/// has a fixed size: a header, a hash table of slots and a data area with
+/// the final bands. A new or invalid file is set up with the given size,
+/// an existing one keeps its size. All accesses are locked with flock(),
+/// so several processes can share the cache.
+///
+/// @param filename Path of the cache file
+/// @param megabytes Size of a new cache file in MB
+/// @param cache The cache to be opened
+/// @return int (0) - no errors
+///         int (9) - opening the cache failed
+//
+int openCache(char* filename, int megabytes, Cache* cache)
+{
+  struct stat file_status;
+  unsigned long long size = (unsigned long long)megabytes << 20;
+  unsigned long long slot_count = 0;
+  CacheHeader header;
+
+  cache->file_ = open(filename, O_RDWR | O_CREAT, 0644);
+  if (cache->file_ < 0 || flock(cache->file_, LOCK_EX) != 0 ||
+      fstat(cache->file_, &file_status) != 0)
+  {
+    closeCache(cache);
+    printf(OPENING_THE_CACHE_FAILED);
+    return ERROR_CODE_OPENING_THE_CACHE_FAILED;
+  }
+
+  memset(&header, 0, sizeof(CacheHeader));
+  if (file_status.st_size >= (off_t)sizeof(CacheHeader) &&
+      pread(cache->file_, &header, sizeof(CacheHeader), 0) ==
+        sizeof(CacheHeader) &&
+      memcmp(header.magic_, CACHE_MAGIC, sizeof(header.magic_)) == 0 &&
+      header.file_size_ == (unsigned long long)file_status.st_size &&
+      header.slot_count_ > 0 &&
+      header.data_offset_ == sizeof(CacheHeader) +
+                             header.slot_count_ * sizeof(CacheSlot) &&
+      header.data_offset_ <= header.file_size_ &&
+      header.data_used_ <= header.file_size_ - header.data_offset_)
+    size = header.file_size_;
+  else
+  {
+    //a new or broken cache starts empty
+    slot_count = size / CACHE_BYTES_PER_SLOT;
+    memcpy(header.magic_, CACHE_MAGIC, sizeof(header.magic_));
+    header.file_size_ = size;
+    header.slot_count_ = slot_count;
+    header.data_offset_ = sizeof(CacheHeader) + slot_count * sizeof(CacheSlot);
+    header.data_used_ = 0;
+    header.data_live_ = 0;
+    header.entry_count_ = 0;
+    header.clock_ = 0;
+    if (ftruncate(cache->file_, 0) != 0 ||
+        ftruncate(cache->file_, size) != 0 ||
+        pwrite(cache->file_, &header, sizeof(CacheHeader), 0) !=
+          sizeof(CacheHeader))
+    {
+      closeCache(cache);
+      printf(OPENING_THE_CACHE_FAILED);
+      return ERROR_CODE_OPENING_THE_CACHE_FAILED;
+    }
+  }
+
+  cache->memory_ = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        cache->file_, 0);
+  flock(cache->file_, LOCK_UN);
+  if (cache->memory_ == MAP_FAILED)
+  {
+    cache->memory_ = NULL;
+    closeCache(cache);
+    printf(OPENING_THE_CACHE_FAILED);
+    return ERROR_CODE_OPENING_THE_CACHE_FAILED;
+  }
+
+  cache->header_ = (CacheHeader*)cache->memory_;
+  cache->slots_ = (CacheSlot*)(cache->memory_ + sizeof(CacheHeader));
+  cache->data_ = cache->memory_ + cache->header_->data_offset_;
+  cache->data_size_ = size - cache->header_->data_offset_;
+
+  return EVERYTHING_WORKED_FINE;
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to set a Breakpoint.
+/// Unmaps and closes the result cache.
+///
+/// @param cache The cache to be closed
+//
+void closeCache(Cache* cache)
+{
+  if (cache->memory_)
+    munmap(cache->memory_, cache->header_->file_size_);
+  if (cache->file_ >= 0)
+    close(cache->file_);
+  cache->memory_ = NULL;
+  cache->header_ = NULL;
+  cache->file_ = -1;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Finds the slot of a key in the hash table (linear probing). The cache
+/// has to be locked.
+///
+/// @param cache The opened cache
+/// @param rules_hash Hash of the rules
+/// @param input_hash Hash of the input
+/// @return unsigned long long Index of the slot with the key, or of the
+///         empty slot where it belongs
+//
+unsigned long long findCacheSlot(Cache* cache, unsigned long long rules_hash,
+                                 unsigned long long input_hash)
+{
+  unsigned long long slot_count = cache->header_->slot_count_;
+  unsigned long long index = (rules_hash ^ input_hash) % slot_count;
+
+  while (cache->slots_[index].last_used_ != 0 &&
+         (cache->slots_[index].rules_hash_ != rules_hash ||
+          cache->slots_[index].input_hash_ != input_hash))
+    index = (index + 1) % slot_count;
+
+  return index;
+}
+
+//-----------------------------------------------------------------------------
 ///
+/// Looks the machine and its input up in the cache. On a hit the final
+/// state, step count, head position and band are restored and the machine
+/// is marked as stopped, so it does not need to be run at all.
+///
+/// @param cache The opened cache
+/// @param rules_hash Hash of the rules
+/// @param input_hash Hash of the input
 /// @param machine Struct with all components to descripe the turing machine
 ///        (state, rules, etc.)
-/// @param type Type of the Breakpoint to be set.
-/// @param value Value of the Breakpoint to be set.
+/// @param max_steps Step limit of the run, 0 for none
+/// @return Boolean (TRUE) - the result was restored from the cache
+///         Boolean (FALSE) - the machine has to be run
 //
-int setBreakPoint(Turing* machine, char* type, char value) //TODO Reallocate if breakpoints > Breakpointslimit
+Boolean lookupCache(Cache* cache, unsigned long long rules_hash,
+                    unsigned long long input_hash, Turing* machine,
+                    long long max_steps)
 {
-  if (type && value)
+  Boolean hit = FALSE;
+  CacheSlot* slot = NULL;
+
+  if (flock(cache->file_, LOCK_EX) != 0)
+    return FALSE;
+
+  slot = &cache->slots_[findCacheSlot(cache, rules_hash, input_hash)];
+  if (slot->last_used_ != 0 &&
+      (max_steps == 0 || slot->step_count_ <= max_steps) &&
+      slot->band_offset_ + slot->band_length_ <= cache->data_size_)
   {
-    int int_value = 0;
-    Boolean is_valide_type = FALSE;
+    long long band_last = slot->band_first_ + (long long)slot->band_length_;
 
-    if (strcmp(type, "write") == 0 || strcmp(type, "read") == 0)
-      is_valide_type = TRUE;
-    else if (strcmp(type, "state") == 0 || strcmp(type, "pos") == 0)
+    if ((slot->band_first_ >= -machine->band_origin_ &&
+         slot->head_position_ >= -machine->band_origin_) ||
+        growBand(machine, slot->band_first_ < slot->head_position_ ?
+                          slot->band_first_ : slot->head_position_) ==
+          EVERYTHING_WORKED_FINE)
+      if ((band_last <= machine->band_capacity_ - machine->band_origin_ &&
+           slot->head_position_ < machine->band_capacity_ -
+                                  machine->band_origin_) ||
+          growBand(machine, band_last > slot->head_position_ ?
+                            band_last : slot->head_position_) ==
+            EVERYTHING_WORKED_FINE)
+        hit = TRUE;
+  }
+
+  if (hit)
+  {
+    memset(machine->band_memory_, '_', machine->band_capacity_);
+    memcpy(machine->band_ + slot->band_first_,
+           cache->data_ + slot->band_offset_, slot->band_length_);
+    machine->current_state_ = slot->final_state_;
+    machine->head_position_ = slot->head_position_;
+    machine->step_count_ = slot->step_count_;
+    machine->turing_over_ = TRUE;
+    slot->last_used_ = ++cache->header_->clock_;
+  }
+
+  flock(cache->file_, LOCK_UN);
+  return hit;
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Stores the result of a stopped machine in the cache. If the hash table
+/// is three quarters full or the data area too small, the least recently
+/// used entries are evicted first. Bands larger than the data area, or
+/// bands which do not fit because the data could not be compacted, are
+/// not stored.
+///
+/// @param cache The opened cache
+/// @param rules_hash Hash of the rules
+/// @param input_hash Hash of the input
+/// @param machine Struct with all components to descripe the turing machine
+///        (state, rules, etc.)
+//
+void storeCache(Cache* cache, unsigned long long rules_hash,
+                unsigned long long input_hash, Turing* machine)
+{
+  int first = 0;
+  int last = -1;
+  unsigned long long band_length = 0;
+  CacheHeader* header = cache->header_;
+  CacheSlot* slot = NULL;
+
+  if (findBandExtent(machine, &first, &last))
+    band_length = (unsigned long long)((long long)last - first + 1);
+  if (band_length > cache->data_size_ || flock(cache->file_, LOCK_EX) != 0)
+    return;
+
+  slot = &cache->slots_[findCacheSlot(cache, rules_hash, input_hash)];
+  if (slot->last_used_ == 0)
+  {
+    while (header->entry_count_ > 0 &&
+           ((header->entry_count_ + 1) * 4 > header->slot_count_ * 3 ||
+            header->data_live_ + band_length > cache->data_size_))
+      evictCacheEntry(cache);
+    if (header->data_used_ + band_length > cache->data_size_ &&
+        (compactCacheData(cache) != EVERYTHING_WORKED_FINE ||
+         header->data_used_ + band_length > cache->data_size_))
     {
-      is_valide_type = TRUE;
-      int_value = value - '0';
+      flock(cache->file_, LOCK_UN);
+      return;
     }
 
-    if (is_valide_type)
+    slot = &cache->slots_[findCacheSlot(cache, rules_hash, input_hash)];
+    slot->rules_hash_ = rules_hash;
+    slot->input_hash_ = input_hash;
+    slot->band_offset_ = header->data_used_;
+    slot->band_length_ = band_length;
+    slot->band_first_ = first;
+    slot->head_position_ = machine->head_position_;
+    slot->final_state_ = machine->current_state_;
+    slot->step_count_ = machine->step_count_;
+    memcpy(cache->data_ + header->data_used_, machine->band_ + first,
+           band_length);
+    header->data_used_ += band_length;
+    header->data_live_ += band_length;
+    header->entry_count_++;
+  }
+  slot->last_used_ = ++header->clock_;
+
+  flock(cache->file_, LOCK_UN);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Evicts the least recently used entry of the cache. Its band stays in
+/// the data area until the data is compacted.
+///
+/// @param cache The opened and locked cache
+//
+void evictCacheEntry(Cache* cache)
+{
+  unsigned long long slot_counter = 0;
+  unsigned long long oldest = 0;
+  unsigned long long oldest_used = ~0ULL;
+
+  for (; slot_counter < cache->header_->slot_count_; slot_counter++)
+    if (cache->slots_[slot_counter].last_used_ != 0 &&
+        cache->slots_[slot_counter].last_used_ < oldest_used)
     {
-      int breakpoint_pos = machine->breakpoint_counter_;
-      machine->breakpoint_counter_++;
-      machine->breakpoints_[breakpoint_pos].type_ = calloc(6, sizeof(char));
-      if(!(machine->breakpoints_[breakpoint_pos].type_))
-      {
-        free(machine->breakpoints_[breakpoint_pos].type_);
-        machine->breakpoints_[breakpoint_pos].type_ = NULL;
-        printf(OUT_OF_MEMORY);
-        return ERROR_CODE_OUT_OF_MEMORY;
-      }
+      oldest = slot_counter;
+      oldest_used = cache->slots_[slot_counter].last_used_;
+    }
 
-      sprintf(machine->breakpoints_[breakpoint_pos].type_, "%s", type);
-      if (strcmp(type, "state") == 0 || strcmp(type, "pos") == 0)
-        machine->breakpoints_[breakpoint_pos].value_ = int_value;
-      else
-        machine->breakpoints_[breakpoint_pos].value_ = value;
+  cache->header_->data_live_ -= cache->slots_[oldest].band_length_;
+  cache->header_->entry_count_--;
+  removeCacheSlot(cache, oldest);
+}
+
+//-----------------------------------------------------------------------------
+///
+/// Empties a slot of the hash table. The following entries of the probe
+/// sequence are shifted back, so lookups never need tombstones.
+///
+/// @param cache The opened and locked cache
+/// @param index Index of the slot to be emptied
+//
+void removeCacheSlot(Cache* cache, unsigned long long index)
+{
+  unsigned long long slot_count = cache->header_->slot_count_;
+  unsigned long long hole = index;
+  unsigned long long next = (index + 1) % slot_count;
+
+  cache->slots_[hole].last_used_ = 0;
+  while (cache->slots_[next].last_used_ != 0)
+  {
+    CacheSlot* slot = &cache->slots_[next];
+    unsigned long long home = (slot->rules_hash_ ^ slot->input_hash_) %
+                              slot_count;
+
+    //the hole lies on the probe sequence of the entry
+    if ((next + slot_count - home) % slot_count >=
+        (next + slot_count - hole) % slot_count)
+    {
+      cache->slots_[hole] = *slot;
+      slot->last_used_ = 0;
+      hole = next;
     }
+    next = (next + 1) % slot_count;
   }
+}
 
-  return EVERYTHING_WORKED_FINE;
+//-----------------------------------------------------------------------------
+///
+/// Compares two cache slots by the offset of their band, for qsort().
+///
+/// @param first Pointer to the first slot pointer
+/// @param second Pointer to the second slot pointer
+/// @return int (<0, 0, >0) - first is stored before, with or after second
+//
+int compareCacheSlots(const void* first, const void* second)
+{
+  unsigned long long first_offset = (*(CacheSlot* const*)first)->band_offset_;
+  unsigned long long second_offset =
+    (*(CacheSlot* const*)second)->band_offset_;
+
+  return (first_offset > second_offset) - (first_offset < second_offset);
 }
 
 //-----------------------------------------------------------------------------
 ///
-/// Function to check whether the given character is a plus or a minus.
+/// Moves the bands of all entries to the start of the data area, so the
+/// space of evicted entries can be used again.
 ///
-/// @param character The Character to be checked.
-/// @return Boolean (TRUE) - is a plus or a minus
-///         Boolean (FALSE) - is not a plus or a minus
+/// @param cache The opened and locked cache
+/// @return int (0) - no errors
+///         int (2) - out of memory, the data was not moved
 //
-Boolean isPlusOrMinus(char character)
+int compactCacheData(Cache* cache)
 {
-  Boolean isPlusOrMinue = FALSE;
-	if (character == '-' || character == '+')
-      isPlusOrMinue = TRUE;
+  unsigned long long slot_counter = 0;
+  unsigned long long entry_counter = 0;
+  unsigned long long data_used = 0;
+  CacheSlot** entries = malloc((cache->header_->entry_count_ + 1) *
+                               sizeof(CacheSlot*));
 
-	return isPlusOrMinue;
+  if (!entries)
+    return ERROR_CODE_OUT_OF_MEMORY;
+
+  for (; slot_counter < cache->header_->slot_count_; slot_counter++)
+    if (cache->slots_[slot_counter].last_used_ != 0)
+      entries[entry_counter++] = &cache->slots_[slot_counter];
+  qsort(entries, entry_counter, sizeof(CacheSlot*), compareCacheSlots);
+
+  for (slot_counter = 0; slot_counter < entry_counter; slot_counter++)
+  {
+    memmove(cache->data_ + data_used,
+            cache->data_ + entries[slot_counter]->band_offset_,
+            entries[slot_counter]->band_length_);
+    entries[slot_counter]->band_offset_ = data_used;
+    data_used += entries[slot_counter]->band_length_;
+  }
+  cache->header_->data_used_ = data_used;
+
+  free(entries);
+  return EVERYTHING_WORKED_FINE;
 }